@@ -0,0 +1,104 @@
+/*!
+ *@file Arena.h
+ *@brief 模块内存池接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_ARENA_H
+#define SYSYC_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief 内存块中存放的对象种类，释放模块时据此调用析构函数
+ */
+enum ArenaKind : uint32_t {
+  kFreeBlock = 0, //!< 已归还到空闲链表
+  kValueBlock,    //!< Value 及其派生类
+  kTypeBlock      //!< Type 及其派生类
+};
+
+/**
+ * @brief 模块持有的内存池，IR 对象均从中分配
+ * @note 大块内存上顺序切分（bump），每个对象前有 16 字节块头，记录所属池、
+ *       尺寸级别与种类；按 16 字节分级的空闲链表回收被 delete 的对象
+ * @note 超过最大级别的对象单独占一个大块，delete 后整块归还系统
+ * @note 函数体可能并行生成，分配与回收加锁
+ */
+class Arena {
+public:
+  Arena() = default;
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+  /**
+   * @brief 析构时归还全部大块，不调用对象的析构函数
+   */
+  ~Arena() { release(); }
+
+  /**
+   * @brief 分配一个对象的空间
+   *
+   * @param size 对象大小
+   * @param kind 对象种类，不可为 kFreeBlock
+   * @return void* 16 字节对齐的对象地址
+   */
+  void *allocate(size_t size, ArenaKind kind);
+  /**
+   * @brief 回收对象空间到所属池的空闲链表，大对象直接归还系统
+   *
+   * @param p allocate 返回的地址，可为 nullptr
+   */
+  static void deallocate(void *p);
+  /**
+   * @brief 按分配顺序遍历所有未回收的对象
+   *
+   * @param fn 回调，参数为对象地址与种类
+   * @note 遍历期间不可分配或回收
+   */
+  void for_each_live(void (*fn)(void *obj, ArenaKind kind));
+  /**
+   * @brief 一次归还全部大块，池中对象随之失效
+   */
+  void release();
+  /**
+   * @brief 已向系统申请的字节数
+   */
+  size_t reserved_bytes() const { return reserved_; }
+
+private:
+  /// @brief 对象块头
+  struct alignas(16) Header {
+    Arena *owner;
+    uint32_t size_class; //!< 块大小 / 16，含块头；大对象为 0
+    ArenaKind kind;
+  };
+  /// @brief 向系统申请的大块，对象从 data 起顺序排列
+  struct alignas(16) Chunk {
+    Chunk *next;
+    Chunk *prev; //!< 只在大对象链表中使用，回收时 O(1) 摘除
+    size_t used; //!< 已切分字节数
+    size_t cap;  //!< 可用字节数
+  };
+  /// @brief 空闲链表节点，复用已回收对象的空间
+  struct FreeNode {
+    FreeNode *next;
+  };
+
+  static constexpr size_t kAlign = 16;
+  static constexpr size_t kChunkSize = 64 * 1024;
+  static constexpr size_t kNumClasses = 64; //!< 最大级别 1024 字节
+
+  static char *chunk_data(Chunk *c) { return reinterpret_cast<char *>(c + 1); }
+  Chunk *new_chunk(size_t cap);
+
+  Chunk *chunks_ = nullptr;   //!< 正在切分的大块在表头
+  Chunk *large_ = nullptr;    //!< 大对象各自的大块
+  FreeNode *free_[kNumClasses] = {};
+  size_t reserved_ = 0;
+  std::mutex mutex_;
+};
+
+#endif // SYSYC_ARENA_H
@@ -9,12 +9,12 @@
 #define SYSYC_BASICBLOCK_H
 
 #include "Function.h"
+#include "IList.h"
 #include "Instruction.h"
 #include "Module.h"
+#include "SmallVector.h"
 #include "Value.h"
 
-#include <list>
-#include <set>
 #include <string>
 #include <vector>
 
@@ -22,16 +22,28 @@ class Function;
 class Instruction;
 class Module;
 
+/// 基本块的指令链表：侵入式，链接指针就在指令中
+using InstList = IList<Instruction>;
+/// 前驱表：每条入边一项，多数块的前驱不超过四个，不申请堆内存
+using PredList = SmallVector<BasicBlock *, 4>;
+/// 后继表：由终结指令得出，至多两项
+using SuccList = SmallVector<BasicBlock *, 2>;
+
 /*!
   @brief 基本块节点
 */
 class BasicBlock : public Value {
 private:
-  std::list<BasicBlock *> pre_bbs_;     //!<  pre basic blocks
-  std::list<BasicBlock *> succ_bbs_;    //!<  subsequence basic blocks
-  std::list<Instruction *> instr_list_; //!<  instruction in basic block
+  PredList pre_bbs_;                    //!<  pre basic blocks, one per edge
+  InstList instr_list_;                 //!<  instruction in basic block
   Function *parent_;                    //!<  belong to which function
   bool _fake;                           //!<  is fake basicblock
+  unsigned number_ = kNoNumber;         //!<  所属函数内的稠密编号
+
+  /*!
+   *@brief 在指令链表的指定位置之前插入指令，并维护前后继指针
+   */
+  void insert_instr_at(InstList::iterator it, Instruction *instr);
 
 public:
   /*!
@@ -54,12 +66,11 @@ public:
    *@return 创建的基本块对象指针
    *@note
    *----------
-   *默认基本块名称为label_()number
+   *有名称的基本块打印为label_名称，未命名的在打印时编号为label数字
    */
   static BasicBlock *create(Module *m, const std::string &name,
                             Function *parent, bool fake = false) {
-    auto prefix = name.empty() ? "" : "label_";
-    return new BasicBlock(m, prefix + name, parent, fake);
+    return new (m) BasicBlock(m, name, parent, fake);
   }
 
   /*!
@@ -72,118 +83,61 @@ public:
   Function *get_parent() { return parent_; }
 
   /*!
-   *@brief 返回基本块的所属模块
-   *@return 从属的模块对象指针
-   *@note
-   *----------
-   *return parent, or null if none.
-   */
-  Module *get_module();
-
-  /*!
-   *@brief 返回基本块的前置基本块链
-   *@return 前置基本块链
-   *@note
-   *----------
-   *return pre_bbs_, or null if none.
-   */
-  std::list<BasicBlock *> &get_pre_basic_blocks() { return pre_bbs_; }
-
-  /*!
-   *@brief 返回基本块的前置基本块链
-   *@return 后置基本块链
-   *@note
-   *----------
-   *return succ_bbs_, or null if none.
-   */
-  std::list<BasicBlock *> &get_succ_basic_blocks() { return succ_bbs_; }
-
-  /*!
-   *@brief 向前置基本块链中插入新的基本块
-   *@param bb 待插入的基本块指针
+   *@brief 将游离的基本块追加到函数末尾
+   *@param parent 所从属的函数
    *@note
    *----------
+   *create 时 parent 为空即得到游离块，可先作为跳转目标使用
    */
-  void add_pre_basic_block(BasicBlock *bb) { pre_bbs_.push_back(bb); }
+  void insert_into(Function *parent);
 
   /*!
-   *@brief 向后置基本块链中插入新的基本块
-   *@param bb 待插入的基本块指针
+   *@brief 返回基本块的所属模块
+   *@return 从属的模块对象指针
    *@note
    *----------
    *return parent, or null if none.
    */
-  void add_succ_basic_block(BasicBlock *bb) { succ_bbs_.push_back(bb); }
-
-  /*!
-   *@brief 更新基本块的前置基本块链
-   *@param bb_list 基本块链的集合
-   *@note
-   *----------
-   *&emsp; 清空原先的前置基本块链
-   *&emsp; 用新的基本块链进行填充
-   */
-  void set_pre_bb(const std::set<BasicBlock *> &bb_list) {
-    pre_bbs_.clear();
-    pre_bbs_.insert(pre_bbs_.begin(), bb_list.begin(), bb_list.end());
-  }
+  Module *get_module();
 
   /*!
-   *@brief 更新基本块的后置基本块链
-   *@param bb_list 基本块链的集合
+   *@brief 返回基本块的前置基本块表
+   *@return 前置基本块表
    *@note
    *----------
-   *&emsp; 清空原先的后置基本块链
-   *&emsp; 用新的基本块链进行填充
+   *每条入边对应一项，按边建立的先后排列；
+   *同一前驱的条件跳转两个目标都是本块时出现两次。
+   *表项由 BranchInst 维护，调用者只应调整顺序
    */
-  void set_succ_bb(const std::set<BasicBlock *> &bb_list) {
-    succ_bbs_.clear();
-    succ_bbs_.insert(succ_bbs_.begin(), bb_list.begin(), bb_list.end());
-  }
+  PredList &get_pre_basic_blocks() { return pre_bbs_; }
 
   /*!
-   *@brief 替换指定的基本块
-   *@param oldBB 被替换的旧基本块指针
-   *@param newBB 用于替换的新基本块指针
+   *@brief 返回基本块的后置基本块
+   *@return 后置基本块表
    *@note
    *----------
-   *####1 替换前置基本块链中的旧基本块
-   *&emsp; **for** 遍历前置链表
-   *&emsp;&emsp; 如果匹配到指定的基本块指针，进行替换
-   *####2 替换后置基本块链中的就基本块
-   *&emsp; **for** 遍历后置链表
-   *&emsp;&emsp; 如果匹配到指定的基本块指针，进行替换
+   *由终结指令的操作数得出：条件跳转依次为真、假分支，
+   *无条件跳转为其目标，ret 或无终结指令时为空
    */
-  void replace_basic_block(BasicBlock *oldBB, BasicBlock *newBB) {
-    for (auto it = pre_bbs_.begin(); it != pre_bbs_.end(); ++it) {
-      if (*it == oldBB) {
-        *it = newBB;
-      }
-    }
-    for (auto it = succ_bbs_.begin(); it != succ_bbs_.end(); ++it) {
-      if (*it == oldBB) {
-        *it = newBB;
-      }
-    }
-  }
+  SuccList get_succ_basic_blocks();
 
   /*!
-   *@brief 删除前置基本块链的指定基本块
-   *@param 待删除的基本块指针
+   *@brief 向前置基本块表中加入一条入边
+   *@param bb 入边的起点
    *@note
    *----------
-   *pre list remove bb
+   *由 BranchInst 在建立跳转时调用；所属函数的 CFG 版本随之改变
    */
-  void remove_pre_basic_block(BasicBlock *bb) { pre_bbs_.remove(bb); }
+  void add_pre_basic_block(BasicBlock *bb);
 
   /*!
-   *@brief 删除后置基本块链的指定基本块
-   *@param 待删除的基本块指针
+   *@brief 删除前置基本块表中的一条入边
+   *@param bb 入边的起点
    *@note
    *----------
-   *succ list remove bb
+   *只删除第一个匹配项，其余入边保持原有顺序；所属函数的 CFG 版本随之改变
    */
-  void remove_succ_basic_block(BasicBlock *bb) { succ_bbs_.remove(bb); }
+  void remove_pre_basic_block(BasicBlock *bb);
 
   /*!
    *@brief 获取基本块内的终结指令
@@ -237,22 +191,56 @@ public:
    */
   void add_instr_after_phi(Instruction *instr);
 
+  /*!
+   *@brief 在块首的phi和alloca指令之后添加指令
+   *@param 待添加的指令指针
+   *@note
+   *----------
+   *用于把alloca集中放在入口块开头
+   */
+  void add_instr_after_alloca(Instruction *instr);
+
+  /*!
+   *@brief 在指定指令之前插入指令
+   *@param pos 本块中的指令
+   *@param instr 待插入的指令指针
+   */
+  void insert_before(Instruction *pos, Instruction *instr);
+
+  /*!
+   *@brief 在指定指令之后插入指令
+   *@param pos 本块中的指令
+   *@param instr 待插入的指令指针
+   */
+  void insert_after(Instruction *pos, Instruction *instr);
+
+  /*!
+   *@brief 把src中从first起到块尾的指令整段移到本块末尾
+   *@param src 源基本块
+   *@param first src中的指令
+   *@note
+   *----------
+   *链表拼接为 O(1)，被移动指令的所属块逐条修正
+   */
+  void splice_from(BasicBlock *src, Instruction *first);
+
   /*!
    *@brief 删除基本块中的某个指令
    *@param 待删除的指令指针
    *@note
    *----------
-   *&emsp; 删除维护的指令链表中的指令
-   *&emsp; 获取删除的指令的前后指令
-   *&emsp; 修正指令的链接关系：，
-   *&emsp; **if** 如果前置指令不为空
-   *&emsp;&emsp; 为前置指令设置新的后置指令
-   *&emsp; **if** 如果后置指令不为空
-   *&emsp;&emsp; 为后置指令设置新的前置指令
+   *&emsp; 从侵入式指令链表摘除，O(1)
    *&emsp; 被删除的指令进行相关use的删除
+   *&emsp; 释放指令，调用者不可再使用该指针
    */
   void delete_instr(Instruction *instr);
 
+  /*!
+   *@brief 从本块摘除指令但保留其操作数，用于移动到别处
+   *@param instr 待摘除的指令指针
+   */
+  void remove_instr(Instruction *instr);
+
   /*!
    *@brief 判断基本块维护的指令链表是否为空
    *@return 指令链表是否为空结果
@@ -271,6 +259,21 @@ public:
    */
   bool is_fake_block() { return _fake; }
 
+  /*!
+   *@brief 所属函数内的稠密编号
+   *@return 小于 Function::get_block_number_bound() 的编号，
+   *        不在函数中时为 kNoNumber
+   *@note
+   *----------
+   *可直接作为 std::vector 或位集的下标，代替以基本块指针为键的映射
+   */
+  unsigned get_number() const { return number_; }
+
+  /*!
+   *@brief 设置稠密编号，由所属函数调用
+   */
+  void set_number(unsigned number) { number_ = number; }
+
   /*!
    *@brief 指针数量
    *@return 返回基本块维护指令链表的指针数量
@@ -285,7 +288,7 @@ public:
    *@note
    *----------
    */
-  std::list<Instruction *> &get_instructions() { return instr_list_; }
+  InstList &get_instructions() { return instr_list_; }
 
   /*!
    *@brief 将基本块从从属的函数中删除
@@ -297,11 +300,9 @@ public:
 
   /*!
    *@brief 打印基本块
-   *@note
-   *----------
-   *return parent, or null if none.
+   *@param os 输出流
    */
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 };
 
 #endif
@@ -0,0 +1,131 @@
+/*!
+ *@file Bitcode.h
+ *@brief 模块二进制格式读写接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_BITCODE_H
+#define SYSYC_BITCODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Module;
+class Function;
+class Type;
+class Value;
+
+/*!
+ *@brief 把模块编码为二进制格式
+ *@param m 模块
+ *@return 编码结果
+ *@note
+ *----------
+ *整数一律为 LEB128 变长编码，依次为：
+ *&emsp; 魔数 "SYBC" 与版本号
+ *&emsp; 字符串表（value 名称，按下标+1 引用，0 表示未命名）
+ *&emsp; 类型表，子类型排在前面
+ *&emsp; 常量表，数组元素排在前面
+ *&emsp; 全局变量表、函数表（含各函数体的字节数）
+ *&emsp; 各函数体：参数名、基本块（名称、前驱顺序）、指令；后继由跳转指令得出
+ *指令的操作数记为当前指令编号与操作数编号之差（有符号），
+ *全局 value 的编号依次为常量、全局变量、函数，局部 value 接在其后
+ */
+std::string write_bitcode(Module *m);
+
+/*!
+ *@brief 把模块以二进制格式写入文件
+ *@param m 模块
+ *@param path 文件路径
+ *@return 是否写入成功
+ */
+bool write_bitcode_file(Module *m, const std::string &path);
+
+/**
+ * @brief 二进制格式的读取器
+ * @note 文件通过 mmap 映射，读取时不整体拷贝
+ * @note 惰性读取时只建立类型、常量、全局变量与函数声明，函数体在
+ *       materialize 时才解码；未解码的函数与声明一样没有基本块
+ * @note 读取器须在惰性读取的函数全部解码之前保持存活
+ */
+class BitcodeReader {
+public:
+  BitcodeReader() = default;
+  BitcodeReader(const BitcodeReader &) = delete;
+  BitcodeReader &operator=(const BitcodeReader &) = delete;
+  ~BitcodeReader();
+
+  /**
+   * @brief 映射文件
+   *
+   * @param path 文件路径
+   * @return bool 是否成功，失败原因见 get_error
+   */
+  bool open(const std::string &path);
+  /**
+   * @brief 直接读取内存中的编码，内存由调用者保持有效
+   *
+   * @param data 编码起始地址
+   * @param size 字节数
+   */
+  void set_buffer(const char *data, size_t size);
+  /**
+   * @brief 把编码内容重建到模块中
+   *
+   * @param m 目标模块，应为空模块
+   * @param lazy 为 true 时函数体留待 materialize
+   * @return bool 是否成功
+   */
+  bool read_module(Module *m, bool lazy = false);
+  /**
+   * @brief 解码一个函数的函数体，已解码或为声明时直接返回 true
+   *
+   * @param f read_module 建立的函数
+   * @return bool 是否成功
+   */
+  bool materialize(Function *f);
+  /**
+   * @brief 解码全部尚未解码的函数体
+   *
+   * @return bool 是否成功
+   */
+  bool materialize_all();
+  /**
+   * @brief 函数体是否已解码
+   */
+  bool is_materialized(Function *f) const;
+  /**
+   * @brief 最近一次失败的原因
+   */
+  const std::string &get_error() const { return error_; }
+
+private:
+  /// @brief 函数体在编码中的位置
+  struct BodyRange {
+    size_t offset;
+    size_t size;
+    bool done;
+  };
+
+  bool fail(const std::string &msg);
+  bool read_body(Function *f, BodyRange &range);
+  void unmap();
+
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  void *mapped_ = nullptr; //!< open 映射的地址，set_buffer 时为空
+  std::string owned_;      //!< 不支持 mmap 的平台上读入的文件内容
+
+  Module *module_ = nullptr;
+  std::vector<std::string> strings_;
+  std::vector<Type *> types_;
+  std::vector<Value *> globals_; //!< 常量、全局变量、函数
+  std::unordered_map<Function *, BodyRange> bodies_;
+  std::string error_;
+};
+
+#endif // SYSYC_BITCODE_H
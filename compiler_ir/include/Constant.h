@@ -82,7 +82,7 @@ public:
    *@brief 打印常量类变量
    *@return 字符串
    */
-  std::string print() override;
+  void print(IROStream &os) override;
 };
 
 class ConstantFloat : public Constant {
@@ -96,7 +96,7 @@ public:
     // 工厂方法
     static ConstantFloat *get(float val, Module *m);
     
-    std::string print() override;
+    void print(IROStream &os) override;
 };
 
 /*!
@@ -151,7 +151,7 @@ public:
    *@return 字符串
    *constant int array
    */
-  std::string print() override;
+  void print(IROStream &os) override;
 
   /*!
    *@brief 常量整数类构造函数
@@ -196,6 +196,7 @@ public:
  */
 class ConstantZero : public Constant {
 private:
+  friend class Module; //!< 由模块的常量池创建
   explicit ConstantZero(Type *ty) : Constant(ty, "", 0) {}
 
 public:
@@ -212,6 +213,6 @@ public:
    *@return 字符串
    *constant int zero
    */
-  std::string print() override;
+  void print(IROStream &os) override;
 };
 #endif // SYSYC_CONSTANT_H
@@ -0,0 +1,56 @@
+/*!
+ *@file ConstantFolder.h
+ *@brief 常量折叠接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_CONSTANTFOLDER_H
+#define SYSYC_CONSTANTFOLDER_H
+
+#include "Constant.h"
+#include "Module.h"
+#include "Instruction.h"
+
+/**
+ * @brief 常量折叠
+ * @note 按 SysY 语义对常量操作数求值：i32 按补码回绕，float 按单精度计算
+ * @note 结果未定义或无法用常量表示时返回 nullptr，由调用方照常生成指令
+ */
+class ConstantFolder {
+public:
+  explicit ConstantFolder(Module *m) : m_(m) {}
+
+  /*!
+   *@brief 折叠二元算术运算
+   *@param op 运算类型，add/sub/mul/sdiv/mod 或对应的浮点运算
+   *@param lhs 左操作数
+   *@param rhs 右操作数
+   *@return 折叠结果；操作数不全为常量、除数为 0、INT_MIN / -1
+   *        或浮点结果非有限值时返回 nullptr
+   */
+  Constant *fold_binary(Instruction::OpID op, Value *lhs, Value *rhs);
+
+  /*!
+   *@brief 折叠比较运算
+   *@param op 比较类型
+   *@param lhs 左操作数
+   *@param rhs 右操作数
+   *@return i1 常量；操作数不全为常量时返回 nullptr
+   */
+  Constant *fold_cmp(CmpInst::CmpOp op, Value *lhs, Value *rhs);
+
+  /*!
+   *@brief 折叠类型转换
+   *@param op zext/sitofp/fptosi
+   *@param val 被转换的值
+   *@param ty 目标类型
+   *@return 折叠结果；fptosi 超出 i32 范围时返回 nullptr
+   */
+  Constant *fold_cast(Instruction::OpID op, Value *val, Type *ty);
+
+private:
+  Module *m_;
+};
+
+#endif // SYSYC_CONSTANTFOLDER_H
@@ -0,0 +1,172 @@
+/*!
+ *@file DominatorTree.h
+ *@brief 支配树与支配边界分析接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_DOMINATORTREE_H
+#define SYSYC_DOMINATORTREE_H
+
+#include <cassert>
+#include <vector>
+
+#include "BasicBlock.h"
+#include "Function.h"
+
+/**
+ * @brief 函数的支配树或后支配树
+ * @note 按 Cooper、Harvey、Kennedy 的迭代算法，在逆后序上反复求
+ *       前驱直接支配者的交，直到不动点；交以后序号沿树上行求得
+ * @note 建树后对树做一次深度优先编号，a 支配 b 当且仅当 b 的进出
+ *       区间落在 a 的区间内，查询为 O(1)
+ * @note 各数组以基本块的稠密编号为下标；后支配树另加一个虚拟出口
+ *       结点作为根，其后继为全部没有后继的块，编号为块编号上界
+ * @note 从入口（后支配树为从任一出口逆向）不可达的块不在树中；
+ *       后支配树中因此不含走不到出口的死循环
+ * @note 一般经 Function::get_dominator_tree 取得缓存的结果；CFG
+ *       改变后缓存作废，再次获取时重新计算
+ */
+class DominatorTree {
+public:
+  /**
+   * @brief 构造并计算支配树
+   * @param func 有函数体的函数
+   * @param post 为 true 时计算后支配树
+   */
+  explicit DominatorTree(Function *func, bool post = false);
+
+  /**
+   * @brief 按函数当前的 CFG 重新计算，支配边界在下次查询时重建
+   */
+  void recalculate();
+
+  /**
+   * @brief 计算后函数的 CFG 是否未再改变
+   */
+  bool is_up_to_date() const { return version_ == func_->get_cfg_version(); }
+
+  /**
+   * @brief 是否为后支配树
+   */
+  bool is_post_dominator() const { return post_; }
+
+  /**
+   * @brief 树根：支配树为入口块，后支配树为虚拟出口的各个子结点
+   */
+  const std::vector<BasicBlock *> &get_roots() const { return roots_; }
+
+  /**
+   * @brief 块是否在树中，即从入口可达（后支配树为可达出口）
+   */
+  bool is_reachable(BasicBlock *bb) const {
+    return idom_[node(bb)] != Value::kNoNumber;
+  }
+
+  /**
+   * @brief 直接支配者
+   * @return 树根、不可达的块以及直接后支配者为虚拟出口的块返回 nullptr
+   */
+  BasicBlock *get_idom(BasicBlock *bb) const;
+
+  /**
+   * @brief 在树中的子结点，即以 bb 为直接支配者的块，按逆后序排列
+   */
+  const std::vector<BasicBlock *> &get_children(BasicBlock *bb) const {
+    return children_[node(bb)];
+  }
+
+  /**
+   * @brief a 是否支配 b
+   * @note 块支配自身；不可达的块被任何块支配，而不支配其它块
+   */
+  bool dominates(BasicBlock *a, BasicBlock *b) const;
+
+  /**
+   * @brief a 是否严格支配 b，即支配且不相同
+   */
+  bool strictly_dominates(BasicBlock *a, BasicBlock *b) const {
+    return a != b && dominates(a, b);
+  }
+
+  /**
+   * @brief 同时支配 a 与 b 的最近的块
+   * @return 任一块不可达，或后支配树中只有虚拟出口同时后支配两者时返回 nullptr
+   */
+  BasicBlock *find_nearest_common_dominator(BasicBlock *a, BasicBlock *b) const;
+
+  /**
+   * @brief 块的支配边界
+   * @note 后支配树上即后支配边界，也就是控制依赖的来源
+   * @note 首次查询时为全部块一并计算，之后直到重新计算前复用
+   */
+  const std::vector<BasicBlock *> &get_dominance_frontier(BasicBlock *bb);
+
+  /**
+   * @brief 可达块的逆后序，后支配树为逆向 CFG 上的逆后序
+   */
+  const std::vector<BasicBlock *> &get_reverse_post_order() const {
+    return rpo_;
+  }
+
+  /**
+   * @brief 打印各块的直接支配者与支配边界
+   * @param os 输出流
+   * @note 块名须已由 Function::number_slots 编号
+   */
+  void print(IROStream &os);
+
+private:
+  /*!
+   *@brief 按分析方向建立前驱后继的压缩邻接表
+   */
+  void build_edges();
+
+  /*!
+   *@brief 从根出发深度优先遍历，求后序号与逆后序
+   */
+  void compute_post_order();
+
+  /*!
+   *@brief 迭代求直接支配者，再建立子结点表与树上的进出区间
+   */
+  void compute_idoms();
+
+  /*!
+   *@brief 求全部块的支配边界
+   */
+  void compute_frontiers();
+
+  /*!
+   *@brief 沿直接支配者上行求两个结点的最近公共祖先
+   */
+  unsigned intersect(unsigned a, unsigned b) const;
+
+  /*!
+   *@brief 块在各数组中的下标，并检查结果未过期
+   */
+  unsigned node(BasicBlock *bb) const {
+    assert(is_up_to_date() && "dominator tree is stale");
+    assert(bb->get_number() < blocks_.size() && bb->get_parent() == func_ &&
+           "block not in this function");
+    return bb->get_number();
+  }
+
+  Function *func_;
+  bool post_;
+  unsigned version_ = 0;                          //!< 计算时的 CFG 版本
+  unsigned root_ = 0;                             //!< 根结点下标
+  std::vector<BasicBlock *> blocks_;              //!< 下标到块，空洞与虚拟出口为空
+  std::vector<unsigned> succ_begin_, succ_;       //!< 分析方向上的后继
+  std::vector<unsigned> pred_begin_, pred_;       //!< 分析方向上的前驱
+  std::vector<unsigned> po_number_;               //!< 后序号，不可达为 kNoNumber
+  std::vector<unsigned> idom_;                    //!< 直接支配者下标，根为自身
+  std::vector<unsigned> dfs_in_, dfs_out_;        //!< 树上深度优先的进出序号
+  std::vector<std::vector<BasicBlock *>> children_;
+  std::vector<BasicBlock *> roots_;
+  std::vector<BasicBlock *> rpo_;
+  std::vector<std::vector<BasicBlock *>> frontier_;
+  bool frontier_built_ = false;
+};
+
+#endif // SYSYC_DOMINATORTREE_H
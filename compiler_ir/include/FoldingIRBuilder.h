@@ -0,0 +1,86 @@
+#ifndef SYSYC_FOLDINGIRBUILDER_H
+#define SYSYC_FOLDINGIRBUILDER_H
+
+#include "ConstantFolder.h"
+#include "IRbuilder.h"
+
+/*!
+ *@brief 带常量折叠的 irbuilder
+ *@note
+ *----------
+ *算术、比较与类型转换的 create_* 在操作数均为常量时直接返回折叠后的常量，
+ *否则照常创建指令；因此返回类型统一为 Value *
+ */
+class FoldingIRBuilder : public IRBuilder {
+private:
+  ConstantFolder folder_;
+
+  Value *binary(Instruction::OpID op, Value *lhs, Value *rhs,
+                BinaryInst *(IRBuilder::*create)(Value *, Value *)) {
+    if (auto c = folder_.fold_binary(op, lhs, rhs)) {
+      return c;
+    }
+    return (this->*create)(lhs, rhs);
+  }
+  Value *cmp(CmpInst::CmpOp op, Value *lhs, Value *rhs,
+             CmpInst *(IRBuilder::*create)(Value *, Value *)) {
+    if (auto c = folder_.fold_cmp(op, lhs, rhs)) {
+      return c;
+    }
+    return (this->*create)(lhs, rhs);
+  }
+
+public:
+  /*!
+   *@brief 带常量折叠的 irbuilder 的构造函数
+   *@param bb 基本块
+   *@param m 模块
+   */
+  FoldingIRBuilder(BasicBlock *bb, Module *m) : IRBuilder(bb, m), folder_(m) {}
+
+  Value *create_iadd(Value *lhs, Value *rhs) { return binary(Instruction::add, lhs, rhs, &IRBuilder::create_iadd); }
+  Value *create_isub(Value *lhs, Value *rhs) { return binary(Instruction::sub, lhs, rhs, &IRBuilder::create_isub); }
+  Value *create_imul(Value *lhs, Value *rhs) { return binary(Instruction::mul, lhs, rhs, &IRBuilder::create_imul); }
+  Value *create_isdiv(Value *lhs, Value *rhs) { return binary(Instruction::sdiv, lhs, rhs, &IRBuilder::create_isdiv); }
+  Value *create_irem(Value *lhs, Value *rhs) { return binary(Instruction::mod, lhs, rhs, &IRBuilder::create_irem); }
+
+  Value *create_fadd(Value *lhs, Value *rhs) { return binary(Instruction::fadd, lhs, rhs, &IRBuilder::create_fadd); }
+  Value *create_fsub(Value *lhs, Value *rhs) { return binary(Instruction::fsub, lhs, rhs, &IRBuilder::create_fsub); }
+  Value *create_fmul(Value *lhs, Value *rhs) { return binary(Instruction::fmul, lhs, rhs, &IRBuilder::create_fmul); }
+  Value *create_fdiv(Value *lhs, Value *rhs) { return binary(Instruction::fdiv, lhs, rhs, &IRBuilder::create_fdiv); }
+
+  Value *create_icmp_eq(Value *lhs, Value *rhs) { return cmp(CmpInst::EQ, lhs, rhs, &IRBuilder::create_icmp_eq); }
+  Value *create_icmp_ne(Value *lhs, Value *rhs) { return cmp(CmpInst::NE, lhs, rhs, &IRBuilder::create_icmp_ne); }
+  Value *create_icmp_gt(Value *lhs, Value *rhs) { return cmp(CmpInst::GT, lhs, rhs, &IRBuilder::create_icmp_gt); }
+  Value *create_icmp_ge(Value *lhs, Value *rhs) { return cmp(CmpInst::GE, lhs, rhs, &IRBuilder::create_icmp_ge); }
+  Value *create_icmp_lt(Value *lhs, Value *rhs) { return cmp(CmpInst::LT, lhs, rhs, &IRBuilder::create_icmp_lt); }
+  Value *create_icmp_le(Value *lhs, Value *rhs) { return cmp(CmpInst::LE, lhs, rhs, &IRBuilder::create_icmp_le); }
+
+  Value *create_fcmp_eq(Value *lhs, Value *rhs) { return cmp(CmpInst::EQ, lhs, rhs, &IRBuilder::create_fcmp_eq); }
+  Value *create_fcmp_ne(Value *lhs, Value *rhs) { return cmp(CmpInst::NE, lhs, rhs, &IRBuilder::create_fcmp_ne); }
+  Value *create_fcmp_gt(Value *lhs, Value *rhs) { return cmp(CmpInst::GT, lhs, rhs, &IRBuilder::create_fcmp_gt); }
+  Value *create_fcmp_ge(Value *lhs, Value *rhs) { return cmp(CmpInst::GE, lhs, rhs, &IRBuilder::create_fcmp_ge); }
+  Value *create_fcmp_lt(Value *lhs, Value *rhs) { return cmp(CmpInst::LT, lhs, rhs, &IRBuilder::create_fcmp_lt); }
+  Value *create_fcmp_le(Value *lhs, Value *rhs) { return cmp(CmpInst::LE, lhs, rhs, &IRBuilder::create_fcmp_le); }
+
+  Value *create_zext(Value *val, Type *ty) {
+    if (auto c = folder_.fold_cast(Instruction::zext, val, ty)) {
+      return c;
+    }
+    return IRBuilder::create_zext(val, ty);
+  }
+  Value *create_sitofp(Value *val, Type *ty) {
+    if (auto c = folder_.fold_cast(Instruction::sitofp, val, ty)) {
+      return c;
+    }
+    return IRBuilder::create_sitofp(val, ty);
+  }
+  Value *create_fptosi(Value *val, Type *ty) {
+    if (auto c = folder_.fold_cast(Instruction::fptosi, val, ty)) {
+      return c;
+    }
+    return IRBuilder::create_fptosi(val, ty);
+  }
+};
+
+#endif // SYSYC_FOLDINGIRBUILDER_H
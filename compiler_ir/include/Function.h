@@ -22,6 +22,7 @@
 class Module;
 class Argument;
 class BasicBlock;
+class DominatorTree;
 class Type;
 class FunctionType;
 
@@ -110,6 +111,23 @@ public:
    * @param bb 基本块指针
    */
   void remove(BasicBlock *bb);
+  /**
+   * @brief 拆分关键边，在 from 与它的一个后继 to 之间插入一个新基本块
+   *
+   * @param from 边的起点，须以跳转指令结束
+   * @param succ_num 边在 from 的跳转中的后继序号
+   * @return BasicBlock* 新基本块，排在 from 之后，只含一条跳转到 to 的指令
+   * @note 只改写该序号的目标，前驱表随之更新；两个目标都是 to 时另一条边不变
+   * @note to 中每个 phi 的一个来自 from 的入口改为来自新块
+   */
+  BasicBlock *split_edge(BasicBlock *from, unsigned succ_num);
+  /**
+   * @brief 释放全部基本块与指令，函数变回声明
+   *
+   * @note 参数保留；函数本身仍可被其它函数调用
+   * @note 用于逐个函数编译：函数输出后即释放函数体，空间由内存池复用
+   */
+  void delete_body();
   /**
    * @brief Get the entry block object，获取基本块入口
    *
@@ -138,22 +156,101 @@ public:
    */
   bool is_declaration() { return basic_blocks_.empty(); }
   /**
-   * @brief Set the instr name object，为参数和基本块设置名称
+   * @brief 为未命名的参数、基本块和指令编号，打印时使用
+   * @note 同名基本块按出现次序编号，第二个起打印时带 .序号 后缀
+   *
+   */
+  void number_slots();
+  /**
+   * @brief 打印函数，打印前先为未命名的value编号
+   *
+   * @param os 输出流
+   */
+  void print(IROStream &os) override;
+
+  /**
+   * @brief 按布局顺序为基本块和指令重新分配从0开始的连续编号
+   *
+   * @note 块与指令各自编号，编号存于对象自身，供分析用 std::vector
+   *       和位集代替以指针为键的映射
+   * @note 之后插入的块和指令继续递增编号，摘除的留下空洞；编号始终
+   *       唯一且小于对应的上界，空洞较多时可再次调用本函数压缩
+   */
+  void renumber();
+  /**
+   * @brief 基本块编号的上界，按此大小开辟以块编号为下标的数组
+   */
+  unsigned get_block_number_bound() const { return block_bound_; }
+  /**
+   * @brief 指令编号的上界，按此大小开辟以指令编号为下标的数组
+   */
+  unsigned get_instr_number_bound() const { return instr_bound_; }
+  /**
+   * @brief 编号是否连续，即自上次 renumber 以来没有摘除过块或指令
+   */
+  bool is_numbering_dense() const { return holes_ == 0; }
+  /**
+   * @brief 为尚未编号的基本块及其中尚未编号的指令分配编号
+   *
+   * @param bb 本函数中的基本块
+   */
+  void assign_number(BasicBlock *bb);
+  /**
+   * @brief 为尚未编号的指令分配编号
+   *
+   * @param instr 本函数中的指令
+   */
+  void assign_number(Instruction *instr) {
+    if (instr->get_number() == kNoNumber) {
+      instr->set_number(instr_bound_++);
+    }
+  }
+  /**
+   * @brief 收回被摘除的指令的编号，留下空洞
+   *
+   * @param instr 刚从本函数摘除的指令
+   */
+  void release_number(Instruction *instr) {
+    if (instr->get_number() != kNoNumber) {
+      instr->set_number(kNoNumber);
+      holes_++;
+    }
+  }
+  /**
+   * @brief CFG 的版本号，块或边每改变一次加一
+   *
+   * @note 据此判断缓存的分析结果是否过期
+   */
+  unsigned get_cfg_version() const { return cfg_version_; }
+  /**
+   * @brief 记录 CFG 已改变，缓存的支配树随之作废
    *
+   * @note 增删基本块、增删入边与重新编号时自动调用
    */
-  void set_instr_name();
+  void invalidate_cfg() { cfg_version_++; }
   /**
-   * @brief 打印函数
+   * @brief 获取支配树，CFG 未改变时复用上次的结果
    *
-   * @return std::string 字符串
+   * @return DominatorTree* 由函数持有，CFG 改变后不可再查询
    */
-  std::string print();
+  DominatorTree *get_dominator_tree();
+  /**
+   * @brief 获取后支配树，CFG 未改变时复用上次的结果
+   *
+   * @return DominatorTree* 由函数持有，CFG 改变后不可再查询
+   */
+  DominatorTree *get_post_dominator_tree();
 
 private:
   std::list<BasicBlock *> basic_blocks_; // basic blocks
   std::list<Argument *> arguments_;      // arguments
   Module *parent_;
-  unsigned seq_cnt_;
+  unsigned block_bound_ = 0; // 已分配的基本块编号上界
+  unsigned instr_bound_ = 0; // 已分配的指令编号上界
+  unsigned holes_ = 0;       // 上次 renumber 以来收回的编号数
+  unsigned cfg_version_ = 0; // CFG 的版本号
+  DominatorTree *dom_tree_ = nullptr;      // 缓存的支配树
+  DominatorTree *post_dom_tree_ = nullptr; // 缓存的后支配树
   /**
    * @brief 创建函数参数列表
    *
@@ -200,7 +297,9 @@ public:
    *
    * @return Argument* ，获取新的参数对象指针
    */
-  Argument *deepcopy() { return new Argument(type_, name_, parent_, arg_no_); }
+  Argument *deepcopy() {
+    return new (type_->get_module()) Argument(type_, get_name(), parent_, arg_no_);
+  }
   /**
    * @brief Get the arg no object，获取参数列表参数个数
    *
@@ -214,9 +313,9 @@ public:
   /**
    * @brief 打印参数列表
    *
-   * @return std::string 字符串
+   * @param os 输出流
    */
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
 private:
   Function *parent_;
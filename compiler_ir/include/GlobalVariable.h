@@ -76,8 +76,8 @@ public:
 
   /*!
    *@brief 打印全局变量
-   *@return 字符串
+   *@param os 输出流
    */
-  std::string print();
+  void print(IROStream &os) override;
 };
 #endif // SYSYC_GLOBALVARIABLE_H
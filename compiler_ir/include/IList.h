@@ -0,0 +1,151 @@
+/*!
+ *@file IList.h
+ *@brief 侵入式双向链表头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_ILIST_H
+#define SYSYC_ILIST_H
+
+#include <cstddef>
+#include <iterator>
+
+/**
+ * @brief 侵入式双向链表
+ * @note 链接指针存放在节点自身（NodeT 需提供 getPrevInst/getSuccInst/
+ *       setPrevInst/setSuccInst），不为每个节点额外分配链表节点
+ * @note 插入、摘除为 O(1)；摘除一个节点不影响指向其它节点的迭代器
+ * @note 写成模板是为了让成员函数在使用处才实例化：Instruction.h 与
+ *       BasicBlock.h 互相包含，声明链表时 NodeT 可能尚不完整
+ */
+template <typename NodeT> class IList {
+public:
+  /*! 双向迭代器，解引用得到节点指针；end() 为空节点，可 -- 回到表尾*/
+  class iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = NodeT *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = NodeT **;
+    using reference = NodeT *;
+
+    iterator() = default;
+    iterator(NodeT *node, const IList *list) : node_(node), list_(list) {}
+    NodeT *operator*() const { return node_; }
+    iterator &operator++() {
+      node_ = node_->getSuccInst();
+      return *this;
+    }
+    iterator &operator--() {
+      node_ = node_ ? node_->getPrevInst() : list_->tail_;
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+    iterator operator--(int) {
+      iterator old = *this;
+      --*this;
+      return old;
+    }
+    bool operator==(const iterator &o) const { return node_ == o.node_; }
+    bool operator!=(const iterator &o) const { return node_ != o.node_; }
+
+  private:
+    NodeT *node_ = nullptr;
+    const IList *list_ = nullptr;
+  };
+  using reverse_iterator = std::reverse_iterator<iterator>;
+
+  iterator begin() const { return iterator(head_, this); }
+  iterator end() const { return iterator(nullptr, this); }
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+  NodeT *front() const { return head_; }
+  NodeT *back() const { return tail_; }
+  bool empty() const { return head_ == nullptr; }
+  size_t size() const { return size_; }
+
+  /*!
+   *@brief 在pos之前插入节点，pos为end()时追加到表尾
+   *@return 指向新插入节点的迭代器
+   */
+  iterator insert(iterator pos, NodeT *node) {
+    NodeT *next = *pos;
+    NodeT *prev = next ? next->getPrevInst() : tail_;
+    node->setPrevInst(prev);
+    node->setSuccInst(next);
+    if (prev) {
+      prev->setSuccInst(node);
+    } else {
+      head_ = node;
+    }
+    if (next) {
+      next->setPrevInst(node);
+    } else {
+      tail_ = node;
+    }
+    size_++;
+    return iterator(node, this);
+  }
+  void push_back(NodeT *node) { insert(end(), node); }
+  void push_front(NodeT *node) { insert(begin(), node); }
+
+  /*!
+   *@brief 摘除节点，被摘除节点的前后指针置空
+   */
+  void remove(NodeT *node) {
+    NodeT *prev = node->getPrevInst();
+    NodeT *next = node->getSuccInst();
+    if (prev) {
+      prev->setSuccInst(next);
+    } else {
+      head_ = next;
+    }
+    if (next) {
+      next->setPrevInst(prev);
+    } else {
+      tail_ = prev;
+    }
+    node->setPrevInst(nullptr);
+    node->setSuccInst(nullptr);
+    size_--;
+  }
+
+  /*!
+   *@brief 把from中从first到表尾的一段整体接到本表末尾
+   *@param count 该段的节点个数
+   *@note 只修改段两端的指针
+   */
+  void splice_back(IList &from, NodeT *first, size_t count) {
+    NodeT *last = from.tail_;
+    NodeT *before = first->getPrevInst();
+    if (before) {
+      before->setSuccInst(nullptr);
+    } else {
+      from.head_ = nullptr;
+    }
+    from.tail_ = before;
+    from.size_ -= count;
+
+    first->setPrevInst(tail_);
+    if (tail_) {
+      tail_->setSuccInst(first);
+    } else {
+      head_ = first;
+    }
+    tail_ = last;
+    size_ += count;
+  }
+
+private:
+  NodeT *head_ = nullptr;
+  NodeT *tail_ = nullptr;
+  size_t size_ = 0;
+};
+
+#endif // SYSYC_ILIST_H
@@ -0,0 +1,85 @@
+/*!
+ *@file IROStream.h
+ *@brief 中间代码输出流接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_IROSTREAM_H
+#define SYSYC_IROSTREAM_H
+
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief 带缓冲的中间代码输出流
+ * @note 绑定 std::ostream 时，缓冲累积到 kBufSize 字节写出一次；
+ *       不绑定时只写入内存缓冲，用于按函数分别渲染再按顺序拼接
+ * @note 整数用 std::to_chars 格式化，不产生临时字符串
+ */
+class IROStream {
+public:
+  /// 缓冲达到该大小时写出
+  static constexpr size_t kBufSize = 64 * 1024;
+
+  /**
+   * @brief 只写入内存缓冲
+   */
+  IROStream() = default;
+  /**
+   * @brief 写入到out
+   *
+   * @param out 目标流
+   */
+  explicit IROStream(std::ostream &out) : out_(&out) {
+    buf_.reserve(kBufSize);
+  }
+  IROStream(const IROStream &) = delete;
+  IROStream &operator=(const IROStream &) = delete;
+  ~IROStream() { flush(); }
+
+  IROStream &write(const char *s, size_t n) {
+    buf_.append(s, n);
+    if (out_ && buf_.size() >= kBufSize) {
+      flush();
+    }
+    return *this;
+  }
+  IROStream &operator<<(const std::string &s) {
+    return write(s.data(), s.size());
+  }
+  IROStream &operator<<(const char *s) {
+    return write(s, std::char_traits<char>::length(s));
+  }
+  IROStream &operator<<(char c) { return write(&c, 1); }
+  template <typename T,
+            typename = std::enable_if_t<std::is_integral<T>::value>>
+  IROStream &operator<<(T v) {
+    char tmp[24];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    return write(tmp, res.ptr - tmp);
+  }
+
+  /**
+   * @brief 把缓冲写出到绑定的流；未绑定时不做任何事
+   */
+  void flush() {
+    if (out_ && !buf_.empty()) {
+      out_->write(buf_.data(), buf_.size());
+      buf_.clear();
+    }
+  }
+  /**
+   * @brief 取走内存缓冲中的内容
+   */
+  std::string take() { return std::move(buf_); }
+
+private:
+  std::ostream *out_ = nullptr;
+  std::string buf_;
+};
+
+#endif // SYSYC_IROSTREAM_H
@@ -0,0 +1,134 @@
+/*!
+ *@file IRReader.h
+ *@brief 文本中间代码读取接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_IRREADER_H
+#define SYSYC_IRREADER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class BasicBlock;
+class Constant;
+class Function;
+class Module;
+class Type;
+class Value;
+
+/**
+ * @brief 文本中间代码的读取器，接受 Module::print 输出的格式
+ * @note 手写的词法分析直接扫描缓冲区，名称以指向缓冲区的 string_view
+ *       查表，读取过程中不为记号分配内存
+ * @note 引用尚未定义的指令时先用同类型的占位value代替，定义时改挂；
+ *       基本块先作为游离块建立，定义其标号时再挂入函数
+ * @note %opN、%argN、%labelN 视为未命名的value，打印时重新编号；
+ *       phi 中的 undef 来源与块后的 "; preds =" 注释都是打印时由前驱表得出的，
+ *       读取时前者略去，后者用于恢复前驱的排列顺序
+ * @note 打印时同名基本块的标号带 .序号 后缀，读取时后缀作为名称的一部分，
+ *       再次打印得到相同的标号
+ */
+class IRReader {
+public:
+  IRReader() = default;
+  IRReader(const IRReader &) = delete;
+  IRReader &operator=(const IRReader &) = delete;
+
+  /**
+   * @brief 读入文件
+   *
+   * @param path 文件路径
+   * @return bool 是否成功，失败原因见 get_error
+   */
+  bool open(const std::string &path);
+  /**
+   * @brief 直接读取内存中的文本，复制一份以便在末尾补零
+   *
+   * @param data 文本起始地址
+   * @param size 字节数
+   */
+  void set_buffer(const char *data, size_t size);
+  /**
+   * @brief 把文本内容建立到模块中
+   *
+   * @param m 目标模块，应为空模块
+   * @return bool 是否成功，失败原因（含行号）见 get_error
+   */
+  bool read_module(Module *m);
+  /**
+   * @brief 文本中 "; ModuleID = '...'" 给出的模块名，没有时为空
+   */
+  const std::string &get_module_id() const { return module_id_; }
+  /**
+   * @brief 文本中 source_filename 给出的源文件名，没有时为空
+   */
+  const std::string &get_source_filename() const { return source_filename_; }
+  /**
+   * @brief 最近一次失败的原因
+   */
+  const std::string &get_error() const { return error_; }
+
+private:
+  /// @brief 函数体内的局部名称
+  struct Local {
+    Value *val;
+    bool defined; //!< 为 false 时 val 是占位value或游离块
+  };
+
+  bool fail(const std::string &msg);
+
+  /// @brief 词法：跳过空白、换行与注释，cur_ 停在下一个记号的首字符；
+  ///        只在行与行之间使用，指令与声明内的记号都在同一行
+  void skip_space();
+  /// @brief 跳过本行内的空白
+  void skip_blank();
+  /// @brief 越过换行之前的空白与注释，返回其中 "; preds =" 注释的内容
+  std::string_view rest_of_line();
+  bool at_line_end();
+  bool consume(char c);
+  bool expect(char c);
+  bool consume_word(std::string_view w);
+  std::string_view word();
+  bool expect_word(std::string_view w);
+  /// @brief 读取 @name 或 %name 中的名称部分，sigil 为前缀字符
+  bool name(char sigil, std::string_view &out);
+  bool integer(long long &out);
+  /// @brief 下一个记号是否为类型
+  bool at_type();
+
+  bool parse_type(Type *&ty);
+  bool parse_constant(Type *ty, Constant *&c);
+  bool parse_global();
+  bool parse_header(Function *&f, std::vector<std::string_view> &arg_names);
+  bool parse_body(Function *f, const std::vector<std::string_view> &arg_names);
+  bool parse_block(Function *f, std::string_view label);
+  bool parse_instruction(BasicBlock *bb);
+  bool parse_value(Type *ty, Value *&v);
+  bool parse_typed_value(Value *&v);
+  bool parse_label(BasicBlock *&bb);
+
+  BasicBlock *block_ref(std::string_view label);
+  bool define_local(std::string_view name, Value *v);
+  bool finish_function();
+
+  std::string text_;
+  const char *cur_ = nullptr;
+  unsigned line_ = 1;
+
+  Module *module_ = nullptr;
+  std::unordered_map<std::string_view, Value *> globals_;
+  std::unordered_map<std::string_view, Local> locals_;
+  std::unordered_map<std::string_view, Local> blocks_;
+  //!< 各基本块的 preds 注释，函数读完后据此恢复前驱顺序
+  std::vector<std::pair<BasicBlock *, std::string_view>> pred_notes_;
+  std::string module_id_;
+  std::string source_filename_;
+  std::string error_;
+};
+
+#endif // SYSYC_IRREADER_H
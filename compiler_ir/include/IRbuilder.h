@@ -2,6 +2,7 @@
 #define SYSYC_IRBUILDER_H
 
 #include "BasicBlock.h"
+#include "Function.h"
 #include "Instruction.h"
 #include "Value.h"
 
@@ -286,6 +287,17 @@ public:
     return AllocaInst::create_alloca(ty, this->BB_);
   }
 
+  /*!
+   *@brief 在当前函数入口块开头创建alloca
+   *@param ty 申请的类型
+   *@return 申请内容指令指针
+   *@note 不受当前插入点影响，alloca统一放在入口块，便于后续提升与栈槽合并
+   */
+  AllocaInst *create_entry_alloca(Type *ty) {
+    return AllocaInst::create_entry_alloca(
+        ty, this->BB_->get_parent()->get_entry_block());
+  }
+
   /*!
    *@brief 创建扩展指令
    *@param value value值指针
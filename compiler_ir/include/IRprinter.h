@@ -9,6 +9,7 @@
 #include "Constant.h"
 #include "Function.h"
 #include "GlobalVariable.h"
+#include "IROStream.h"
 #include "Instruction.h"
 #include "Module.h"
 #include "Type.h"
@@ -17,7 +18,7 @@
 
 /*!
  *@brief 打印operands的名称
- *@return 字符串
+ *@param os 输出流
  *@note
  *---------
  *初始化字符串
@@ -26,9 +27,17 @@
  *&emsp;&emsp; **else if** 如果属于函数量，打印@+对应名称
  *&emsp;&emsp; **else if** 如果属于常量，打印对应名称
  *&emsp;&emsp; **else** 如果属于普通变量，打印%+对应名称
- *&emsp; 返回字符串
  */
-std::string print_as_op(Value *v, bool print_ty);
+void print_as_op(IROStream &os, Value *v, bool print_ty);
+
+/*!
+ *@brief 局部value（参数、基本块、指令）的打印名称，不含%
+ *@param os 输出流
+ *@note
+ *---------
+ *未命名的value使用所属函数打印时分配的编号
+ */
+void print_name(IROStream &os, Value *v);
 
 /*!
  *@brief 打印比较operands的名称
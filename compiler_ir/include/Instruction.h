@@ -50,7 +50,9 @@ public:
   };
   // create instruction, auto insert to bb
   // ty here is result type
-  Instruction(Type *ty, OpID id, unsigned num_ops, BasicBlock *parent);
+  // inline_ops/inline_cap 为对象之后的use空间，见User
+  Instruction(Type *ty, OpID id, unsigned num_ops, BasicBlock *parent,
+              Use *inline_ops = nullptr, unsigned inline_cap = 0);
   Instruction(Type *ty, OpID id, unsigned num_ops);
   inline const BasicBlock *get_parent() const { return parent_; }
   inline BasicBlock *get_parent() { return parent_; }
@@ -65,6 +67,7 @@ public:
 private:
   Instruction *_prev_inst = nullptr;
   Instruction *_next_inst = nullptr;
+  unsigned number_ = kNoNumber; // 所属函数内的稠密编号
 
 public:
   Instruction *getPrevInst() const { return _prev_inst; }
@@ -72,31 +75,24 @@ public:
   void setPrevInst(Instruction *inst) { _prev_inst = inst; }
   void setSuccInst(Instruction *inst) { _next_inst = inst; }
 
+  // 所属函数内的稠密编号，小于 Function::get_instr_number_bound()；
+  // 可作为 std::vector 或位集的下标。不在函数中时为 kNoNumber
+  unsigned get_number() const { return number_; }
+  // 由所属函数调用
+  void set_number(unsigned number) { number_ = number; }
+
   /// ============= INLINE OPTIMIZATION HELPER FUNCTIONS ==============
 
   // 创建一个指令的深拷贝
   virtual Instruction *deepcopy(BasicBlock *parent) = 0;
   // 利用map映射替换指令内部所有指针到新值
   virtual void transplant(std::map<Value *, Value *> ptMap) {
-    // 替换UseList
-    auto it = use_list_.begin();
-    auto ite = use_list_.end();
-    while (it != ite) {
-      auto u = *it;
-      if (ptMap.find(u.val_) != ptMap.end()) {
-        *it = Use(ptMap[u.val_], u.arg_no_);
-      }
-      it++;
-    }
-    // 替换Operands
-    auto it1 = operands_.begin();
-    auto ite1 = operands_.end();
-    while (it1 != ite1) {
-      auto o = *it1;
-      if (ptMap.find(o) != ptMap.end()) {
-        *it1 = ptMap[o];
+    // 替换Operands，经set_operand同步维护被替换value的use链
+    for (unsigned i = 0; i < get_num_operand(); i++) {
+      auto it = ptMap.find(get_operand(i));
+      if (it != ptMap.end()) {
+        set_operand(i, it->second);
       }
-      it1++;
     }
   };
 
@@ -216,10 +212,44 @@ protected:
   unsigned num_ops_;
 };
 
-class BinaryInst : public Instruction {
+/**
+ * @brief 操作数个数有上限的指令的公共基类
+ * @note N 个 use 紧跟在对象之后，经 new (m) D(...) 与指令一次分配；
+ *       D 为最终派生类，对象大小与内联空间的位置都按 D 计算
+ * @note 类内声明了 operator new，须同时给出两个 operator delete：
+ *       带 Module* 的版本在构造函数抛出异常时归还空间，
+ *       普通版本供 delete 表达式使用，两者都交给 Value 的内存池
+ */
+template <class D, unsigned N> class InlineOperandInst : public Instruction {
+public:
+  //! 内联操作数个数
+  static constexpr unsigned kInlineOps = N;
+
+  static void *operator new(size_t size, Module *m) {
+    return allocate_with_operands(size, m, N);
+  }
+  static void operator delete(void *p, Module *m) {
+    Value::operator delete(p, m);
+  }
+  static void operator delete(void *p) { Value::operator delete(p); }
+
+protected:
+  InlineOperandInst(Type *ty, OpID id, unsigned num_ops, BasicBlock *bb)
+      : Instruction(ty, id, num_ops, bb, operands_after(this), N) {}
+
+private:
+  //! 构造期间 D 尚未成形，不能把 this 转为 D*；单继承下基类子对象位于
+  //! 对象起始处，按 sizeof(D) 直接求出对象之后的位置
+  static Use *operands_after(InlineOperandInst *self) {
+    return reinterpret_cast<Use *>(reinterpret_cast<char *>(self) + sizeof(D));
+  }
+};
+
+class BinaryInst final : public InlineOperandInst<BinaryInst, 2> {
 private:
   BinaryInst(Type *ty, OpID id, Value *v1, Value *v2, BasicBlock *bb);
-  BinaryInst(Type *ty, OpID id, BasicBlock *bb) : Instruction(ty, id, 2, bb){};
+  BinaryInst(Type *ty, OpID id, BasicBlock *bb)
+      : InlineOperandInst(ty, id, 2, bb){};
 
 public:
   // create add instruction, auto insert to bb
@@ -248,21 +278,14 @@ public:
   
   virtual BinaryInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    BinaryInst *newInst = new BinaryInst(type_, op_id_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    BinaryInst *newInst =
+        new (type_->get_module()) BinaryInst(type_, op_id_, parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   int calculate() final;
 
@@ -272,7 +295,7 @@ private:
   void assertValid();
 };
 
-class CmpInst : public Instruction {
+class CmpInst final : public InlineOperandInst<CmpInst, 2> {
 public:
   enum CmpOp {
     EQ, // ==
@@ -286,7 +309,7 @@ public:
 private:
   CmpInst(Type *ty, CmpOp op, Value *lhs, Value *rhs, BasicBlock *bb);
   CmpInst(Type *ty, CmpOp op, BasicBlock *bb)
-      : Instruction(ty, Instruction::cmp, 2, bb), cmp_op_(op){};
+      : InlineOperandInst(ty, Instruction::cmp, 2, bb), cmp_op_(op){};
 
 public:
   static CmpInst *create_cmp(CmpOp op, Value *lhs, Value *rhs, BasicBlock *bb,
@@ -300,21 +323,14 @@ public:
 
   virtual CmpInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    CmpInst *newInst = new CmpInst(type_, cmp_op_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    CmpInst *newInst =
+        new (type_->get_module()) CmpInst(type_, cmp_op_, parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
 private:
   CmpOp cmp_op_;
@@ -334,48 +350,29 @@ public:
                           BasicBlock *bb);
   FunctionType *get_function_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual CallInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    CallInst *newInst = new CallInst(type_, operands_.size(), parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    CallInst *newInst =
+        new (type_->get_module()) CallInst(type_, get_num_operand(), parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
   virtual void transplant(std::map<Value *, Value *> ptMap) override {
-    // 替换UseList
-    auto it = use_list_.begin();
-    auto ite = use_list_.end();
-    while (it != ite) {
-      auto u = *it;
-      if (ptMap.find(u.val_) != ptMap.end()) {
-        *it = Use(ptMap[u.val_], u.arg_no_);
-      }
-    }
     // 替换Operands，跳过第一个。第一个为函数指针，无需处理
-    auto it1 = operands_.begin();
-    auto ite1 = operands_.end();
-    it1++;
-    while (it1 != ite1) {
-      auto o = *it1;
-      if (ptMap.find(o) != ptMap.end()) {
-        *it1 = ptMap[o];
+    for (unsigned i = 1; i < get_num_operand(); i++) {
+      auto it = ptMap.find(get_operand(i));
+      if (it != ptMap.end()) {
+        set_operand(i, it->second);
       }
     }
   };
 };
 
-class BranchInst : public Instruction {
+class BranchInst final : public InlineOperandInst<BranchInst, 3> {
 private:
   BranchInst(Value *cond, BasicBlock *if_true, BasicBlock *if_false,
              BasicBlock *bb);
@@ -397,26 +394,41 @@ public:
   BasicBlock *getTrueBB() const;
   BasicBlock *getFalseBB() const;
 
-  virtual std::string print() override;
+  // 后继个数：条件跳转为2，依次为真、假分支；无条件跳转为1
+  unsigned get_num_successors() const { return is_cond_br() ? 2 : 1; }
+  BasicBlock *get_successor(unsigned i) const;
+  // 改写第i个后继，同步维护新旧目标块的前驱表
+  void set_successor(unsigned i, BasicBlock *bb);
+
+  // 在各目标块的前驱表中登记本指令所在块，已登记时不做任何事
+  void link_edges();
+  // 撤销登记的出边，用于摘除或删除本指令
+  void unlink_edges();
+  bool is_linked() const { return linked_; }
+
+  virtual void print(IROStream &os) override;
 
   virtual BranchInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    BranchInst *newInst = new BranchInst(num_ops_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    BranchInst *newInst =
+        new (type_->get_module()) BranchInst(num_ops_, parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
+    newInst->link_edges();
     return newInst;
   };
+  // 目标块经set_successor替换，保持前驱表同步
+  virtual void transplant(std::map<Value *, Value *> ptMap) override;
+
+private:
+  unsigned successor_operand(unsigned i) const {
+    return is_cond_br() ? i + 1 : i;
+  }
+
+  bool linked_ = false; //!< 出边是否已登记在目标块的前驱表中
 };
 
-class ReturnInst : public Instruction {
+class ReturnInst final : public InlineOperandInst<ReturnInst, 1> {
 private:
   ReturnInst(Value *val, BasicBlock *bb);
   ReturnInst(BasicBlock *bb);
@@ -427,21 +439,14 @@ public:
   static ReturnInst *create_void_ret(BasicBlock *bb);
   bool is_void_ret() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual ReturnInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    ReturnInst *newInst = new ReturnInst(parent, num_ops_);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    ReturnInst *newInst =
+        new (type_->get_module()) ReturnInst(parent, num_ops_);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 };
@@ -459,22 +464,15 @@ public:
                                        BasicBlock *bb);
   Type *get_element_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual GetElementPtrInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
     GetElementPtrInst *newInst =
-        new GetElementPtrInst(element_ty_, num_ops_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+        new (type_->get_module())
+            GetElementPtrInst(element_ty_, num_ops_, parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
@@ -482,7 +480,7 @@ private:
   Type *element_ty_;
 };
 
-class StoreInst : public Instruction {
+class StoreInst final : public InlineOperandInst<StoreInst, 2> {
 private:
   StoreInst(Value *val, Value *ptr, BasicBlock *bb);
   StoreInst(BasicBlock *bb);
@@ -493,30 +491,22 @@ public:
   Value *get_rval() { return this->get_operand(0); }
   Value *get_lval() { return this->get_operand(1); }
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual StoreInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    StoreInst *newInst = new StoreInst(parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    StoreInst *newInst = new (type_->get_module()) StoreInst(parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 };
 
-class LoadInst : public Instruction {
+class LoadInst final : public InlineOperandInst<LoadInst, 1> {
 private:
   LoadInst(Type *ty, Value *ptr, BasicBlock *bb);
   LoadInst(Type *ty, BasicBlock *bb)
-      : Instruction(ty, Instruction::load, 1, bb){};
+      : InlineOperandInst(ty, Instruction::load, 1, bb){};
 
 public:
   static LoadInst *create_load(Type *ty, Value *ptr, BasicBlock *bb);
@@ -524,21 +514,13 @@ public:
 
   Type *get_load_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual LoadInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    LoadInst *newInst = new LoadInst(type_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    LoadInst *newInst = new (type_->get_module()) LoadInst(type_, parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 };
@@ -546,23 +528,25 @@ public:
 class AllocaInst : public Instruction {
 private:
   AllocaInst(Type *ty, BasicBlock *bb);
+  AllocaInst(Type *ty);
 
 public:
   static AllocaInst *create_alloca(Type *ty, BasicBlock *bb);
+  /*!
+   *@brief 在函数入口块开头的alloca序列末尾创建alloca
+   *@param ty 申请的类型
+   *@param entry 函数入口块
+   */
+  static AllocaInst *create_entry_alloca(Type *ty, BasicBlock *entry);
 
   Type *get_alloca_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual AllocaInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    AllocaInst *newInst = new AllocaInst(alloca_ty_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    newInst->operands_.clear();
+    AllocaInst *newInst =
+        new (type_->get_module()) AllocaInst(alloca_ty_, parent);
     return newInst;
   };
   void set_init() { init = true; }
@@ -574,33 +558,25 @@ private:
 };
 
 // 位扩展指令
-class ZextInst : public Instruction {
+class ZextInst final : public InlineOperandInst<ZextInst, 1> {
   friend class IRBuilder;
 private:
   ZextInst(OpID op, Value *val, Type *ty, BasicBlock *bb);
   ZextInst(Type *ty, BasicBlock *bb)
-      : Instruction(ty, Instruction::zext, 1, bb), dest_ty_(ty){};
+      : InlineOperandInst(ty, Instruction::zext, 1, bb), dest_ty_(ty){};
 
 public:
   static ZextInst *create_zext(Value *val, Type *ty, BasicBlock *bb);
 
   Type *get_dest_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual ZextInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    ZextInst *newInst = new ZextInst(type_, parent);
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    ZextInst *newInst = new (type_->get_module()) ZextInst(type_, parent);
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
@@ -609,29 +585,22 @@ private:
 };
 
 // 【新增】浮点转整数指令类定义
-class FpToSiInst : public Instruction {
+class FpToSiInst final : public InlineOperandInst<FpToSiInst, 1> {
 private:
   FpToSiInst(OpID op, Value *val, Type *ty, BasicBlock *bb);
   FpToSiInst(Type *ty, BasicBlock *bb)
-      : Instruction(ty, Instruction::fptosi, 1, bb), dest_ty_(ty){};
+      : InlineOperandInst(ty, Instruction::fptosi, 1, bb), dest_ty_(ty){};
 
 public:
   static FpToSiInst *create_fptosi(Value *val, Type *ty, BasicBlock *bb);
 
   Type *get_dest_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual FpToSiInst *deepcopy(BasicBlock *parent) override {
-    FpToSiInst *newInst = new FpToSiInst(type_, parent);
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    FpToSiInst *newInst = new (type_->get_module()) FpToSiInst(type_, parent);
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
@@ -640,29 +609,22 @@ private:
 };
 
 // 【新增】整数转浮点指令类定义
-class SiToFpInst : public Instruction {
+class SiToFpInst final : public InlineOperandInst<SiToFpInst, 1> {
 private:
   SiToFpInst(OpID op, Value *val, Type *ty, BasicBlock *bb);
   SiToFpInst(Type *ty, BasicBlock *bb)
-      : Instruction(ty, Instruction::sitofp, 1, bb), dest_ty_(ty){};
+      : InlineOperandInst(ty, Instruction::sitofp, 1, bb), dest_ty_(ty){};
 
 public:
   static SiToFpInst *create_sitofp(Value *val, Type *ty, BasicBlock *bb);
 
   Type *get_dest_type() const;
 
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual SiToFpInst *deepcopy(BasicBlock *parent) override {
-    SiToFpInst *newInst = new SiToFpInst(type_, parent);
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    SiToFpInst *newInst = new (type_->get_module()) SiToFpInst(type_, parent);
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
@@ -694,44 +656,21 @@ public:
       }
     }
   }
-  virtual std::string print() override;
+  virtual void print(IROStream &os) override;
 
   virtual PhiInst *deepcopy(BasicBlock *parent) override {
     // 复制基本信息
-    PhiInst *newInst = new PhiInst(type_, num_ops_, parent);
+    PhiInst *newInst =
+        new (type_->get_module()) PhiInst(type_, num_ops_, parent);
     newInst->l_val_ = l_val_;
-    // 复制UseList
-    newInst->use_list_.clear();
-    for (auto u : use_list_) {
-      newInst->use_list_.push_back(u);
-    }
-    // 复制Operands
-    newInst->operands_.clear();
-    for (auto o : operands_) {
-      newInst->operands_.push_back(o);
-    }
+    // 复制Operands，新指令尚无使用者
+    newInst->copy_operands_from(this);
     return newInst;
   };
 
   virtual void transplant(std::map<Value *, Value *> ptMap) override {
-    // 替换UseList
-    auto it = use_list_.begin();
-    auto ite = use_list_.end();
-    while (it != ite) {
-      auto u = *it;
-      if (ptMap.find(u.val_) != ptMap.end()) {
-        *it = Use(ptMap[u.val_], u.arg_no_);
-      }
-    }
     // 替换Operands
-    auto it1 = operands_.begin();
-    auto ite1 = operands_.end();
-    while (it1 != ite1) {
-      auto o = *it1;
-      if (ptMap.find(o) != ptMap.end()) {
-        *it1 = ptMap[o];
-      }
-    }
+    Instruction::transplant(ptMap);
     // 替换lval
     if (ptMap.find(l_val_) != ptMap.end())
       l_val_ = ptMap[l_val_];
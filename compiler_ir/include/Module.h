@@ -8,17 +8,28 @@
 #ifndef SYSYC_MODULE_H
 #define SYSYC_MODULE_H
 
+#include <cstdint>
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "Arena.h"
 #include "Function.h"
 #include "GlobalVariable.h"
+#include "IROStream.h"
 #include "Instruction.h"
 #include "Type.h"
 #include "Value.h"
 
 class GlobalVariable;
+class ConstantInt;
+class ConstantFloat;
+class ConstantZero;
 
 /**
  * @brief 模块类，中间结构的大类
@@ -26,6 +37,9 @@ class GlobalVariable;
  */
 class Module {
 private:
+  /// @brief 内存池：模块内的类型、常量、函数、基本块与指令都从这里分配
+  Arena arena_;
+
   /// @brief 各基础类型指针
   IntegerType *int1_ty_;
   IntegerType *int32_ty_;
@@ -33,17 +47,52 @@ private:
   Type *void_ty_;
   FloatType *float32_ty_;
 
-  /// @brief 指针映射图和数组映射图
-  std::map<Type *, PointerType *> pointer_map_;
-  std::map<std::pair<Type *, int>, ArrayType *> array_map_;
+  /// @brief 派生类型的结构哈希，按成员类型指针组合
+  struct TypeKeyHash {
+    static size_t mix(size_t seed, size_t v) {
+      return seed ^ (v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+    size_t operator()(const std::pair<Type *, unsigned> &k) const {
+      return mix(std::hash<Type *>()(k.first), k.second);
+    }
+    size_t operator()(const std::vector<Type *> &k) const {
+      size_t seed = k.size();
+      for (auto ty : k) {
+        seed = mix(seed, std::hash<Type *>()(ty));
+      }
+      return seed;
+    }
+  };
+  /// @brief 派生类型表：按结构唯一化，结构相同的类型是同一个对象
+  std::unordered_map<Type *, PointerType *> pointer_map_;
+  std::unordered_map<std::pair<Type *, unsigned>, ArrayType *, TypeKeyHash>
+      array_map_;
+  /// @brief 函数类型表，键为返回类型后接各参数类型
+  std::unordered_map<std::vector<Type *>, FunctionType *, TypeKeyHash>
+      function_map_;
+  /// @brief 保护派生类型表，函数体可能并行生成
+  std::mutex type_mutex_;
+
+  /// @brief 常量池：按 (类型, 位模式) 唯一化，值相等的常量是同一个对象
+  std::map<std::pair<IntegerType *, int>, ConstantInt *> int_pool_;
+  std::map<uint32_t, ConstantFloat *> float_pool_;
+  std::map<Type *, ConstantZero *> zero_pool_;
+  /// @brief 保护常量池
+  std::mutex constant_mutex_;
 
   /// @brief 全局变量列表
   /// The Global Variables in the module
   std::list<GlobalVariable *> global_list_;
   /// The Functions in the module
   std::list<Function *> function_list_;
-  /// Symbol table for values
-  std::map<std::string, Value *> value_sym_;
+  /// Symbol table for values，函数与全局量的名称索引
+  std::unordered_map<std::string, Value *> value_sym_;
+  /// @brief 保护函数/全局量列表与名称索引
+  std::mutex symbol_mutex_;
+  /// @brief value名称的驻留表，节点地址稳定，value只保存指针
+  std::unordered_set<std::string> names_;
+  /// @brief 保护名称驻留表
+  std::mutex name_mutex_;
   /// Instruction from opid to string
   std::map<Instruction::OpID, std::string> instr_id2string_;
   /// Human readable identifier for the module
@@ -64,6 +113,13 @@ public:
    */
   ~Module();
 
+  /**
+   * @brief Get the arena object，获取模块的内存池
+   *
+   * @return Arena&
+   */
+  Arena &get_arena() { return arena_; }
+
   /**
    * @brief Get the void type object，获取一个构建好的void类型指针
    *
@@ -121,6 +177,44 @@ public:
    * @return ArrayType*
    */
   ArrayType *get_array_type(Type *contained, unsigned num_elements);
+  /**
+   * @brief Get the function type object，获取一个构建好的函数类型指针
+   *
+   * @param result 返回类型
+   * @param params 参数类型列表
+   * @return FunctionType* 签名相同的函数类型始终返回同一对象
+   */
+  FunctionType *get_function_type(Type *result,
+                                  const std::vector<Type *> &params);
+  /**
+   * @brief 获取唯一化的整数常量
+   *
+   * @param ty 整数类型（i1 或 i32）
+   * @param val 常量值
+   * @return ConstantInt* 同类型同值的常量始终返回同一对象
+   */
+  ConstantInt *get_constant_int(IntegerType *ty, int val);
+  /**
+   * @brief 获取唯一化的浮点常量
+   *
+   * @param val 常量值，按位模式区分（0.0 与 -0.0 是不同常量）
+   * @return ConstantFloat*
+   */
+  ConstantFloat *get_constant_float(float val);
+  /**
+   * @brief 获取唯一化的零初始化常量
+   *
+   * @param ty 常量类型
+   * @return ConstantZero*
+   */
+  ConstantZero *get_constant_zero(Type *ty);
+  /**
+   * @brief 驻留value名称
+   *
+   * @param name 非空名称
+   * @return const std::string* 同名字符串始终返回同一地址，随模块释放
+   */
+  const std::string *intern_name(const std::string &name);
   /**
    * @brief 添加函数
    *
@@ -130,9 +224,16 @@ public:
   /**
    * @brief Get the functions object，获取函数列表
    *
-   * @return std::list<Function *> 函数列表
+   * @return const std::list<Function *>& 函数列表的常量引用
    */
-  std::list<Function *> get_functions();
+  const std::list<Function *> &get_functions() const { return function_list_; }
+  /**
+   * @brief Get the function object，按名称查找函数
+   *
+   * @param name 函数名称
+   * @return Function* 函数指针，不存在时为nullptr
+   */
+  Function *get_function(const std::string &name);
   /**
    * @brief 添加全局量
    *
@@ -144,27 +245,54 @@ public:
    *
    * @param g 全局量指针
    */
-  void delete_global_variable(GlobalVariable *g) { global_list_.remove(g); }
+  void delete_global_variable(GlobalVariable *g);
   /**
    * @brief Get the global variable object，获取全局量指针数组
    *
-   * @return std::list<GlobalVariable *> 全局量指针数组
+   * @return const std::list<GlobalVariable *>& 全局量指针数组的常量引用
    */
-  std::list<GlobalVariable *> get_global_variable();
+  const std::list<GlobalVariable *> &get_global_variable() const {
+    return global_list_;
+  }
+  /**
+   * @brief Get the global variable object，按名称查找全局量
+   *
+   * @param name 全局量名称
+   * @return GlobalVariable* 全局量指针，不存在时为nullptr
+   */
+  GlobalVariable *get_global_variable(const std::string &name);
   /**
    * @brief Get the instr op name object，获取指令
    *
    * @param instr 指令id
-   * @return std::string ID的字符串表达
+   * @return const std::string& ID的字符串表达，未登记的id为空串
+   * @note 只读查找，可在并行打印时调用
    */
-  std::string get_instr_op_name(Instruction::OpID instr) {
-    return instr_id2string_[instr];
+  const std::string &get_instr_op_name(Instruction::OpID instr) const {
+    static const std::string empty;
+    auto it = instr_id2string_.find(instr);
+    return it == instr_id2string_.end() ? empty : it->second;
   }
   /**
-   * @brief Set the print name object，修正模块管理的函数下的名称
+   * @brief Set the print name object，为各函数中未命名的value编号
    *
    */
   void set_print_name();
+  /**
+   * @brief 打印中间代码到输出流
+   *
+   * @param os 输出流
+   * @param jobs 并行渲染函数体的线程数，不大于 1 时顺序打印
+   * @note 并行时各函数先渲染到各自的缓冲，再按函数顺序写出，
+   *       输出与顺序打印逐字节相同
+   */
+  void print(IROStream &os, int jobs = 1);
+  /**
+   * @brief 只打印全局变量，即 print 输出中函数之前的部分
+   *
+   * @param os 输出流
+   */
+  void print_globals(IROStream &os);
   /**
    * @brief 打印中间代码
    *
@@ -0,0 +1,81 @@
+/*!
+ *@file PassManager.h
+ *@brief 函数级优化过程管理接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_PASSMANAGER_H
+#define SYSYC_PASSMANAGER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Module.h"
+
+/**
+ * @brief 按名称组装并执行的函数级优化过程序列
+ * @note 每个过程依次作用于模块中每个有函数体的函数，
+ *       全部函数处理完才开始下一个过程
+ * @note 可选记录各过程的累计耗时，用于比较不同的过程序列
+ */
+class PassManager {
+public:
+  /// @brief 已登记的过程
+  struct PassInfo {
+    const char *name;
+    const char *description;
+    /// 处理一个函数，返回被删除或合并的指令数
+    int (*run)(Function *f);
+  };
+
+  /**
+   * @brief 全部已登记的过程
+   *
+   * @return const std::vector<PassInfo>& 按名称排列
+   */
+  static const std::vector<PassInfo> &registry();
+
+  /**
+   * @brief 在序列末尾追加过程
+   *
+   * @param name 过程名称，见 registry
+   * @return bool 名称未登记时返回 false
+   */
+  bool add(const std::string &name);
+  /**
+   * @brief 按逗号分隔的名称列表追加过程
+   *
+   * @param list 如 "constfold,dce"
+   * @return bool 存在未登记的名称时返回 false，此前的名称已追加
+   */
+  bool add_list(const std::string &list);
+  /**
+   * @brief 记录各过程耗时
+   */
+  void set_time_passes(bool on) { time_passes_ = on; }
+  /**
+   * @brief 依次执行序列中的过程
+   *
+   * @param m 模块
+   */
+  void run(Module *m);
+  /**
+   * @brief 输出各过程的累计耗时与改动的指令数
+   *
+   * @param os 输出流
+   */
+  void print_timing(std::ostream &os) const;
+
+private:
+  struct Entry {
+    const PassInfo *info;
+    double seconds;
+    long changed;
+  };
+  std::vector<Entry> passes_;
+  bool time_passes_ = false;
+};
+
+#endif // SYSYC_PASSMANAGER_H
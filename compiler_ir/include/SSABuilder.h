@@ -0,0 +1,94 @@
+/*!
+ *@file SSABuilder.h
+ *@brief 边生成边构造SSA的接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_SSABUILDER_H
+#define SYSYC_SSABUILDER_H
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "BasicBlock.h"
+#include "Instruction.h"
+#include "Module.h"
+
+/**
+ * @brief 按 Braun 等人的算法在生成 IR 时直接构造 SSA
+ * @note 前端以任意 Value* 标识一个标量变量，每次赋值调用 write_variable，
+ *       每次读取调用 read_variable，得到的即是该点的 SSA 值，不经过内存
+ * @note 基本块的前驱全部生成后调用 seal_block；未封闭块中的读取先放置
+ *       不完整的 phi，封闭时再补全操作数；只有一个不同来源的 phi 随即删除
+ */
+class SSABuilder {
+public:
+  /**
+   * @brief 构造SSA构造器
+   * @param m 所属模块，用于生成未定义值的常量
+   */
+  explicit SSABuilder(Module *m) : module_(m) {}
+
+  /**
+   * @brief 记录变量在基本块中的当前定义
+   * @param var 变量标识
+   * @param bb 所在基本块
+   * @param val 新的值
+   */
+  void write_variable(Value *var, BasicBlock *bb, Value *val);
+
+  /**
+   * @brief 读取变量在基本块末尾处的值
+   * @param var 变量标识
+   * @param ty 变量类型，没有任何定义时返回该类型的零值
+   * @param bb 所在基本块
+   * @return 变量当前的 SSA 值
+   */
+  Value *read_variable(Value *var, Type *ty, BasicBlock *bb);
+
+  /**
+   * @brief 封闭基本块：其前驱已全部确定，补全块内不完整的 phi
+   * @param bb 待封闭的基本块
+   */
+  void seal_block(BasicBlock *bb);
+
+  /**
+   * @brief 基本块是否已封闭
+   */
+  bool is_sealed(BasicBlock *bb) const { return sealed_.count(bb) != 0; }
+
+private:
+  /*!
+   *@brief 在基本块开头放置该变量的空 phi
+   */
+  PhiInst *new_phi(Value *var, Type *ty, BasicBlock *bb);
+
+  /*!
+   *@brief 为 phi 从每个前驱读取变量值作为操作数，然后尝试删除
+   */
+  Value *add_phi_operands(Value *var, PhiInst *phi);
+
+  /*!
+   *@brief phi 除自身外只有一个不同的来源时，用该来源替换并删除 phi
+   *@return phi 最终被替换成的值，不可删除时为 phi 本身
+   */
+  Value *try_remove_trivial_phi(PhiInst *phi);
+
+  /*!
+   *@brief 未定义值：变量在某条路径上没有被赋值，取该类型的零
+   */
+  Value *undef(Type *ty);
+
+  Module *module_;
+  //!< 变量 -> (基本块 -> 块末尾的定义)
+  std::unordered_map<Value *, std::unordered_map<BasicBlock *, Value *>> current_def_;
+  //!< 未封闭块中等待补全的 (变量, phi)
+  std::unordered_map<BasicBlock *, std::vector<std::pair<Value *, PhiInst *>>> incomplete_phis_;
+  //!< phi 所代表的变量，删除 phi 时据此修正 current_def_
+  std::unordered_map<PhiInst *, Value *> phi_var_;
+  std::unordered_set<BasicBlock *> sealed_;
+};
+
+#endif // SYSYC_SSABUILDER_H
@@ -0,0 +1,132 @@
+/*!
+ *@file SmallVector.h
+ *@brief 带内联存储的小数组头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_SMALLVECTOR_H
+#define SYSYC_SMALLVECTOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief 前 N 个元素存放在对象内部的数组
+ * @note 不超过 N 个元素时不申请堆内存，元素连续存放，按指针迭代
+ * @note 只用于可平凡复制的元素（如指针），扩容与拷贝按字节进行
+ */
+template <typename T, unsigned N> class SmallVector {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SmallVector only holds trivially copyable elements");
+
+public:
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  SmallVector() = default;
+  SmallVector(const SmallVector &o) { append(o.begin(), o.end()); }
+  SmallVector(SmallVector &&o) noexcept { take(o); }
+  SmallVector &operator=(const SmallVector &o) {
+    if (this != &o) {
+      clear();
+      append(o.begin(), o.end());
+    }
+    return *this;
+  }
+  SmallVector &operator=(SmallVector &&o) noexcept {
+    if (this != &o) {
+      release();
+      take(o);
+    }
+    return *this;
+  }
+  ~SmallVector() { release(); }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T &operator[](size_t i) { return data_[i]; }
+  const T &operator[](size_t i) const { return data_[i]; }
+  T &front() { return data_[0]; }
+  const T &front() const { return data_[0]; }
+  T &back() { return data_[size_ - 1]; }
+  const T &back() const { return data_[size_ - 1]; }
+
+  void push_back(const T &v) {
+    if (size_ == cap_) {
+      grow(cap_ * 2);
+    }
+    data_[size_++] = v;
+  }
+  void pop_back() { size_--; }
+  void clear() { size_ = 0; }
+  void append(const_iterator first, const_iterator last) {
+    size_t n = last - first;
+    if (size_ + n > cap_) {
+      grow(size_ + n > cap_ * 2 ? size_ + n : cap_ * 2);
+    }
+    std::memcpy(static_cast<void *>(data_ + size_), first, n * sizeof(T));
+    size_ += n;
+  }
+  /*!
+   *@brief 删除pos处的元素，其后元素前移，保持原有顺序
+   *@return 指向被删除元素之后元素的迭代器
+   */
+  iterator erase(iterator pos) {
+    assert(pos >= begin() && pos < end() && "erase out of range");
+    std::memmove(static_cast<void *>(pos), pos + 1,
+                 (end() - pos - 1) * sizeof(T));
+    size_--;
+    return pos;
+  }
+
+private:
+  void grow(size_t cap) {
+    T *mem = static_cast<T *>(std::malloc(cap * sizeof(T)));
+    if (!mem) {
+      throw std::bad_alloc();
+    }
+    std::memcpy(static_cast<void *>(mem), data_, size_ * sizeof(T));
+    release();
+    data_ = mem;
+    cap_ = cap;
+  }
+  bool is_inline() const {
+    return data_ == reinterpret_cast<const T *>(inline_);
+  }
+  void release() {
+    if (!is_inline()) {
+      std::free(data_);
+      data_ = reinterpret_cast<T *>(inline_);
+      cap_ = N;
+    }
+  }
+  /// 接管o的元素，o变为空数组
+  void take(SmallVector &o) {
+    if (o.is_inline()) {
+      std::memcpy(static_cast<void *>(inline_), o.inline_, o.size_ * sizeof(T));
+    } else {
+      data_ = o.data_;
+      cap_ = o.cap_;
+      o.data_ = reinterpret_cast<T *>(o.inline_);
+      o.cap_ = N;
+    }
+    size_ = o.size_;
+    o.size_ = 0;
+  }
+
+  alignas(T) unsigned char inline_[N * sizeof(T)];
+  T *data_ = reinterpret_cast<T *>(inline_);
+  size_t size_ = 0;
+  size_t cap_ = N;
+};
+
+#endif // SYSYC_SMALLVECTOR_H
@@ -0,0 +1,69 @@
+/*!
+ *@file StackColoring.h
+ *@brief 栈槽合并接口头文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#ifndef SYSYC_STACKCOLORING_H
+#define SYSYC_STACKCOLORING_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Function.h"
+#include "Instruction.h"
+
+/**
+ * @brief 栈槽着色
+ * @note 合并生命周期互不重叠的同类型 alloca，缩小栈帧
+ * @note 只处理入口块中仅被 load/store 直接访问的 alloca；
+ *       在入口处就活跃（可能先读后写）的槽位保持独立
+ */
+class StackColoring {
+public:
+  /**
+   * @brief 构造栈槽着色过程
+   * @param func 待处理的函数
+   */
+  explicit StackColoring(Function *func) : func_(func) {}
+
+  /**
+   * @brief 执行合并
+   * @return 被合并删除的 alloca 数量
+   */
+  int run();
+
+private:
+  using BitSet = std::vector<uint64_t>;
+
+  /*!
+   *@brief 收集可合并的 alloca：地址只作为 load/store 的指针操作数
+   */
+  void collect_slots();
+
+  /*!
+   *@brief 逐块计算 use/def，迭代求出块出口活跃集合
+   */
+  void compute_liveness();
+
+  /*!
+   *@brief 在每个 store 处，被写槽位与此刻活跃的其它槽位互相冲突
+   */
+  void build_interference();
+
+  /*!
+   *@brief 返回指令直接访问的槽位编号，不访问槽位时返回 -1
+   */
+  int slot_of(Instruction *inst);
+
+  Function *func_;
+  std::vector<AllocaInst *> slots_;                 //!< 候选槽位
+  std::unordered_map<Value *, int> slot_id_;        //!< alloca 到槽位编号
+  std::vector<BitSet> live_in_;                     //!< 以块编号为下标
+  std::vector<BitSet> live_out_;
+  std::vector<BitSet> interfere_;                   //!< 冲突矩阵
+};
+
+#endif // SYSYC_STACKCOLORING_H
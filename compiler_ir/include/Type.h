@@ -9,6 +9,8 @@
 #define SYSYC_TYPE_H
 
 #include <iostream>
+#include <mutex>
+#include <string>
 #include <vector>
 
 class Module;
@@ -43,8 +45,18 @@ public:
 private:
   TypeID tid_;
   Module *m_;
+  /// @brief 类型的文本表示，首次打印时生成，之后直接复用
+  std::string spelling_;
+  std::once_flag spelling_once_;
   virtual void _t(){};
 
+  /**
+   * @brief 生成类型的文本表示
+   *
+   * @return std::string
+   */
+  std::string render();
+
 public:
   /**
    * @brief Construct a new Type object
@@ -59,6 +71,22 @@ public:
    */
   virtual ~Type() = default;
 
+  /**
+   * @brief 在模块的内存池中分配，模块析构时一并释放
+   *
+   * @param size 对象大小
+   * @param m 所属模块
+   */
+  static void *operator new(size_t size, Module *m);
+  /**
+   * @brief 归还到内存池的空闲链表
+   */
+  static void operator delete(void *p);
+  /**
+   * @brief 构造函数抛出异常时归还空间
+   */
+  static void operator delete(void *p, Module *m);
+
   /**
    * @brief Get the type id object，获取类型ID
    *
@@ -145,6 +173,7 @@ public:
    *
    * @return true 是
    * @return false 不是
+   * @note 派生类型都由模块按结构唯一化，指针相等即结构相同
    */
   static bool is_eq_type(Type *ty1, Type *ty2);
 
@@ -251,9 +280,9 @@ public:
   /**
    * @brief 打印类型
    *
-   * @return std::string，字符串
+   * @return const std::string& 缓存的文本表示，并行打印时也只生成一次
    */
-  std::string print();
+  const std::string &print();
 };
 
 /**
@@ -353,7 +382,7 @@ public:
    *
    * @param result 返回参数类型指针
    * @param params 参数类型指针数组
-   * @return FunctionType* 函数类型指针
+   * @return FunctionType* 函数类型指针，签名相同时返回同一对象
    */
   static FunctionType *get(Type *result, std::vector<Type *> params);
 
@@ -11,12 +11,39 @@
 #include "Value.h"
 #include <vector>
 
-/*! user类，中间IR的基础*/
+/*! user类，中间IR的基础
+ *
+ * 操作数个数固定的指令把use数组放在对象之后，与对象一次分配；
+ * 变长的（call、phi、gep、常量数组等）使用单独分配的hung_off_数组。
+ */
 class User : public Value {
 private:
+  /*!
+   *@brief 内联空间放不下时，把操作数搬到hung_off_
+   */
+  void move_to_hung_off();
+
 protected:
-  std::vector<Value *> operands_; // operands of this value
+  Use *operands_;   // operands of this value，每个操作数即一个use节点
   unsigned num_ops_;              // value值的个数
+  unsigned inline_cap_;           // 对象之后可容纳的use个数，0表示没有内联空间
+  std::vector<Use> hung_off_;     // 没有内联空间时的操作数数组
+
+  /*!
+   *@brief 为对象及其后的n个use分配空间
+   *@param size 对象大小
+   *@param m 所属模块
+   *@param n 内联use个数
+   */
+  static void *allocate_with_operands(size_t size, Module *m, unsigned n);
+
+  /*!
+   *@brief 对象之后的内联use空间
+   *@note T须为最终派生类（final），否则该位置会与派生类成员重叠
+   */
+  template <typename T> static Use *trailing_operands(T *self) {
+    return reinterpret_cast<Use *>(self + 1);
+  }
 
 public:
   /*!
@@ -24,20 +51,24 @@ public:
    *@param ty 类型
    *@param name User名称
    *@param num_ops value的位置
+   *@param inline_ops 对象之后的use空间，nullptr表示使用hung_off_
+   *@param inline_cap 内联空间可容纳的use个数
    *@return 当前对象本身
    */
-  User(Type *ty, const std::string &name = "", unsigned num_ops = 0);
+  User(Type *ty, const std::string &name = "", unsigned num_ops = 0,
+       Use *inline_ops = nullptr, unsigned inline_cap = 0);
 
   /*!
-   *@brief Value的析构函数
+   *@brief User的析构函数
+   *@note 将全部操作数的use从对应value的use链摘除
    */
-  ~User() = default;
+  ~User();
 
   /*!
    *@brief 获得包含value指针的数组
-   *@return 返回User维护的Value数组
+   *@return 操作数的副本
    */
-  std::vector<Value *> &get_operands();
+  std::vector<Value *> get_operands() const;
 
   /*!
    *@brief 获得数组中的第i个value数值指针
@@ -82,6 +113,13 @@ public:
    */
   void remove_use_of_ops();
 
+  /*!
+   *@brief 把全部操作数置空
+   *@note 与remove_use_of_ops不同，use不再记住原先的value，
+   *      之后析构本对象不会再访问任何其它value
+   */
+  void drop_all_operands();
+
   /*!
    *@brief 添加新的value数值指针
    *@param index1 索引1
@@ -89,6 +127,13 @@ public:
    *@note
    */
   void remove_operands(int index1, int index2);
+
+  /*!
+   *@brief 复制另一user的全部操作数
+   *@param src 源user
+   *@note 用于指令的深拷贝，只建立操作数的use，不复制src的使用者
+   */
+  void copy_operands_from(const User *src);
 };
 
 #endif // SYSYC_USER_H
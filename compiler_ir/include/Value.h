@@ -8,18 +8,56 @@
 #ifndef SYSYC_VALUE_H
 #define SYSYC_VALUE_H
 
+#include <cstddef>
 #include <iostream>
 #include <list>
 #include <string>
 
+class IROStream;
+class Module;
 class Type;
 class Value;
 
-/*! use结构体，作为中间IR的基础*/
+/*! use结构体，作为中间IR的基础
+ *
+ * 侵入式双向链表节点：Use 存放在使用者（User）的操作数数组中，
+ * 同时挂在被使用value的use链上，增删与替换都是 O(1)，无需额外分配。
+ * prev_ 指向前一节点的 next_（或链表头），摘除时不必区分是否为首节点。
+ */
 struct Use {
-  Value *val_;      // 使用value的value
+  Value *val_;      // 使用value的value，即所属的User
   unsigned arg_no_; // the no. of operand, e.g., func(a, b), a is 0, b is 1
+  Value *used_ = nullptr; // 被使用的value
+  Use *next_ = nullptr;   // use链中的下一节点
+  Use **prev_ = nullptr;  // 指向前一节点next_的指针，未挂链时为nullptr
+
   Use(Value *val, unsigned no) : val_(val), arg_no_(no) {} // 构造函数
+  Use(const Use &) = delete;
+  Use &operator=(const Use &) = delete;
+  /*!
+   *@brief 移动构造：操作数数组扩容时，节点在链上的位置转移到新地址
+   */
+  Use(Use &&other) noexcept;
+  /*!
+   *@brief 移动赋值：先摘除自身，再接管other在链上的位置
+   */
+  Use &operator=(Use &&other) noexcept;
+
+  /*!
+   *@brief 获取被使用的value
+   */
+  Value *get() const { return used_; }
+
+  /*!
+   *@brief 改为使用新的value：从旧value的use链摘除，挂到新value的use链
+   *@param v 新的value，可为nullptr
+   */
+  void set(Value *v);
+
+  /*!
+   *@brief 从use链摘除，保留used_
+   */
+  void unlink();
 
   /*!
    *@brief 判定两个use是否相等
@@ -32,15 +70,56 @@ struct Use {
   }
 };
 
+/*! use链的遍历视图，元素为Use的引用*/
+class UseList {
+public:
+  class iterator {
+  public:
+    explicit iterator(Use *u) : use_(u) {}
+    Use &operator*() const { return *use_; }
+    Use *operator->() const { return use_; }
+    iterator &operator++() {
+      use_ = use_->next_;
+      return *this;
+    }
+    bool operator==(const iterator &o) const { return use_ == o.use_; }
+    bool operator!=(const iterator &o) const { return use_ != o.use_; }
+
+  private:
+    Use *use_;
+  };
+
+  explicit UseList(Use *head) : head_(head) {}
+  iterator begin() const { return iterator(head_); }
+  iterator end() const { return iterator(nullptr); }
+  bool empty() const { return head_ == nullptr; }
+  /*!
+   *@brief 使用者个数，需遍历链表
+   */
+  size_t size() const;
+
+private:
+  Use *head_;
+};
+
 /*! value类，作为中间IR的基础*/
 class Value {
 private:
+  friend struct Use; // use节点在数组中移动时需要按本value加锁
+
 protected:
   Type *type_;
-  std::list<Use> use_list_; // 使用value的value list
-  std::string name_;        // value名称
+  Use *use_head_ = nullptr; // 使用value的use链表头
+  const std::string *name_ = nullptr; // value名称，驻留在模块的名称表中；未命名为nullptr
+  bool shared_ = false;     // 是否被多个函数共同引用，是则use list的修改需加锁
+  unsigned slot_;           // 打印时为未命名value分配的编号
 
 public:
+  /// 尚未编号
+  static constexpr unsigned kNoSlot = ~0u;
+  /// 尚未分配所属函数内的稠密编号，见 Function::renumber
+  static constexpr unsigned kNoNumber = ~0u;
+
   /*!
    *@brief Value的构造函数
    *@param ty 类型
@@ -51,7 +130,22 @@ public:
   /*!
    *@brief Value的析构函数
    */
-  ~Value() = default;
+  virtual ~Value() = default;
+
+  /*!
+   *@brief 在模块的内存池中分配，模块析构时一并释放
+   *@param size 对象大小
+   *@param m 所属模块
+   */
+  static void *operator new(size_t size, Module *m);
+  /*!
+   *@brief 提前释放的对象归还到内存池的空闲链表
+   */
+  static void operator delete(void *p);
+  /*!
+   *@brief 构造函数抛出异常时归还空间
+   */
+  static void operator delete(void *p, Module *m);
 
   /*!
    *@brief 获取value的类型
@@ -61,16 +155,24 @@ public:
 
   /*!
    *@brief 获取使用该value的use list
-   *@return 返回use-list的引用
+   *@return use链的遍历视图，遍历时不可修改该链
+   */
+  UseList get_use_list() const { return UseList(use_head_); }
+
+  /*!
+   *@brief 标记value被多个函数共享
+   *@note
+   *---------
+   *函数与全局变量会被并行生成的多个函数体同时引用，
+   *标记后add_use/remove_use按地址分段加锁，其余value不受影响
    */
-  std::list<Use> &get_use_list() { return use_list_; }
+  void set_shared() { shared_ = true; }
 
   /*!
-   *@brief 添加use
-   *@param val 使用该value的value
-   *@param arg_no 在指令中的顺序
+   *@brief 将use挂到本value的use链头部
+   *@param use 使用者操作数数组中的use节点
    */
-  void add_use(Value *val, unsigned arg_no = 0);
+  void add_use(Use *use);
 
   /*!
    *@brief 对于value设置名称
@@ -80,19 +182,28 @@ public:
    *---------
    *名字为空即设置新名字，设置后不再进行修改
    */
-  bool set_name(std::string name) {
-    if (name_ == "") {
-      name_ = name;
-      return true;
-    }
-    return false;
-  }
+  bool set_name(const std::string &name);
 
   /*!
    *@brief 获取value的名称
-   *@return value字符串常量
+   *@return value名称，未命名时为空串
    */
-  std::string get_name() const;
+  const std::string &get_name() const;
+
+  /*!
+   *@brief 是否有显式名称
+   */
+  bool has_name() const { return name_ != nullptr; }
+
+  /*!
+   *@brief 获取打印编号，未命名的value在所属函数打印时编号
+   */
+  unsigned get_slot() const { return slot_; }
+
+  /*!
+   *@brief 设置打印编号
+   */
+  void set_slot(unsigned slot) { slot_ = slot; }
 
   /*!
    *@brief 替换所有对于旧value的引用，改为新的
@@ -104,22 +215,19 @@ public:
   void replace_all_use_with(Value *new_val);
 
   /*!
-   *@brief 替换所有对于旧value的引用，改为新的
-   *@param val value型指针
-   *@note
-   *----------
-   *支持对于指令级别value的替换
+   *@brief 从本value的use链摘除指定use
+   *@param use 已挂在本链上的use节点
    */
-  void remove_use(Value *val);
+  void remove_use(Use *use);
 
   /*!
    *@brief value的打印
-   *@return 默认为空
+   *@param os 输出流
    *@note
    *--------
-   *后期根据不同类型的value进行修改，作为一个虚函数出现
+   *默认不输出，后期根据不同类型的value进行修改，作为一个虚函数出现
    */
-  virtual std::string print() { return ""; }
+  virtual void print(IROStream &) {}
 };
 
 #endif // SYSYC_VALUE_H
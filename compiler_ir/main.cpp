@@ -1,5 +1,169 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
 
-int main(){
+#include "Bitcode.h"
+#include "IRReader.h"
+#include "Module.h"
+#include "PassManager.h"
+
+// 独立的中间代码优化器：读入文本中间代码（Module::print 的输出）或二进制模块，
+// 执行指定的过程序列后输出文本；不经过前端，可直接处理缓存的 .ll/.bc 与手写的中间代码
+
+static void usage() {
+    std::cerr << "Usage: ./project1 <input.ll|input.bc> [-passes=p1,p2,...] [-o <file>] [--emit-bc <file>] [--lazy] [-j <threads>] [--time-passes] [--list-passes]" << std::endl;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 文件以二进制格式的魔数开头
+static bool isBitcodeFile(const std::string& path) {
+    char magic[4] = {};
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    size_t n = std::fread(magic, 1, sizeof(magic), fp);
+    std::fclose(fp);
+    return n == sizeof(magic) && std::memcmp(magic, "SYBC", sizeof(magic)) == 0;
+}
+
+int main(int argc, char** argv) {
+    // 可选参数：
+    //   -passes=p1,p2   依次执行的过程，可重复给出；也可写作 --passes p1,p2
+    //   -o file         输出文件，默认标准输出
+    //   --emit-bc file  另将优化后的模块以二进制格式写入 file
+    //   --lazy          二进制输入先只读模块头，再逐个函数解码函数体，输出与直接读入相同
+    //   -j N            并行输出函数的线程数，0 表示使用全部硬件线程
+    //   --time-passes   在标准错误上输出读取、各过程与输出的耗时
+    //   --list-passes   列出可用的过程
+    std::string inputFile;
+    std::string outputFile;
+    std::string bitcodeFile;
+    int jobs = 1;
+    bool timePasses = false;
+    bool lazy = false;
+    PassManager pm;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string passes;
+        if (arg.rfind("-passes=", 0) == 0 || arg.rfind("--passes=", 0) == 0) {
+            passes = arg.substr(arg.find('=') + 1);
+        } else if ((arg == "-passes" || arg == "--passes") && i + 1 < argc) {
+            passes = argv[++i];
+        } else if (arg == "-o" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--emit-bc" && i + 1 < argc) {
+            bitcodeFile = argv[++i];
+        } else if (arg == "-j" && i + 1 < argc) {
+            jobs = std::atoi(argv[++i]);
+            continue;
+        } else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+            jobs = std::atoi(arg.c_str() + 2);
+            continue;
+        } else if (arg == "--lazy") {
+            lazy = true;
+            continue;
+        } else if (arg == "--time-passes") {
+            timePasses = true;
+            continue;
+        } else if (arg == "--list-passes") {
+            for (auto& info : PassManager::registry()) {
+                std::printf("  %-16s %s\n", info.name, info.description);
+            }
+            return 0;
+        } else if (!arg.empty() && arg[0] != '-' && inputFile.empty()) {
+            inputFile = arg;
+            continue;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            usage();
+            return 1;
+        }
+        if (!passes.empty() && !pm.add_list(passes)) {
+            std::cerr << "Unknown pass in '" << passes << "', see --list-passes" << std::endl;
+            return 1;
+        }
+    }
+    if (inputFile.empty()) {
+        usage();
+        return 1;
+    }
+    if (jobs <= 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    pm.set_time_passes(timePasses);
+
+    // 1. 读入模块
+    auto start = std::chrono::steady_clock::now();
+    Module module(inputFile);
+    std::string moduleId = inputFile;
+    std::string sourceFile;
+    if (isBitcodeFile(inputFile)) {
+        BitcodeReader reader;
+        if (!reader.open(inputFile) || !reader.read_module(&module, lazy)) {
+            std::cerr << inputFile << ": " << reader.get_error() << std::endl;
+            return 1;
+        }
+        // 逆序逐个解码，函数体引用的函数可能尚未解码，以此检验各函数体可以单独重建
+        auto& funcs = module.get_functions();
+        for (auto it = funcs.rbegin(); lazy && it != funcs.rend(); ++it) {
+            if (!reader.materialize(*it)) {
+                std::cerr << inputFile << ": " << reader.get_error() << std::endl;
+                return 1;
+            }
+        }
+    } else {
+        IRReader reader;
+        if (!reader.open(inputFile) || !reader.read_module(&module)) {
+            std::cerr << inputFile << ": " << reader.get_error() << std::endl;
+            return 1;
+        }
+        if (!reader.get_module_id().empty()) moduleId = reader.get_module_id();
+        sourceFile = reader.get_source_filename();
+    }
+    double readTime = secondsSince(start);
+
+    // 2. 执行过程序列
+    pm.run(&module);
+
+    if (!bitcodeFile.empty() && !write_bitcode_file(&module, bitcodeFile)) {
+        std::cerr << "Cannot write " << bitcodeFile << std::endl;
+        return 1;
+    }
+
+    // 3. 输出，头部与编译器的输出相同
+    start = std::chrono::steady_clock::now();
+    std::ofstream outFile;
+    if (!outputFile.empty()) {
+        outFile.open(outputFile, std::ios::binary);
+        if (!outFile) {
+            std::cerr << "Cannot write " << outputFile << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = outputFile.empty() ? std::cout : outFile;
+    out << "; ModuleID = '" << moduleId << "'" << std::endl;
+    if (!sourceFile.empty()) out << "source_filename = \"" << sourceFile << "\"" << std::endl;
+    {
+        IROStream os(out);
+        module.print(os, jobs);
+        os << '\n';
+    }
+    out.flush();
+    double printTime = secondsSince(start);
+
+    if (timePasses) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "%10.4fs  read %s\n", readTime, inputFile.c_str());
+        std::cerr << line;
+        pm.print_timing(std::cerr);
+        std::snprintf(line, sizeof(line), "%10.4fs  print\n", printTime);
+        std::cerr << line;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,157 @@
+/*!
+ *@file Arena.cpp
+ *@brief 模块内存池定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "Arena.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+/*!
+ *@brief 向系统申请一个大块
+ *@param cap 可用字节数
+ */
+Arena::Chunk *Arena::new_chunk(size_t cap) {
+  void *mem = std::malloc(sizeof(Chunk) + cap);
+  if (!mem) {
+    throw std::bad_alloc();
+  }
+  reserved_ += sizeof(Chunk) + cap;
+  Chunk *c = static_cast<Chunk *>(mem);
+  c->next = nullptr;
+  c->prev = nullptr;
+  c->used = 0;
+  c->cap = cap;
+  return c;
+}
+
+/*!
+ *@brief 分配一个对象的空间
+ *@param size 对象大小
+ *@param kind 对象种类
+ *@note
+ *----------
+ *&emsp; 块头加对象按 16 字节取整得到尺寸级别
+ *&emsp; 该级别空闲链表非空时直接取用
+ *&emsp; 否则在当前大块上切分，剩余空间不足时换新大块
+ *&emsp; 超过最大级别的对象单独申请大块
+ */
+void *Arena::allocate(size_t size, ArenaKind kind) {
+  assert(kind != kFreeBlock);
+  size_t total = (sizeof(Header) + size + kAlign - 1) & ~(kAlign - 1);
+  size_t cls = total / kAlign;
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  Header *h;
+  if (cls >= kNumClasses) {
+    Chunk *c = new_chunk(total);
+    c->used = total;
+    c->next = large_;
+    if (large_) {
+      large_->prev = c;
+    }
+    large_ = c;
+    h = reinterpret_cast<Header *>(chunk_data(c));
+    cls = 0;
+  } else if (free_[cls]) {
+    FreeNode *n = free_[cls];
+    free_[cls] = n->next;
+    h = reinterpret_cast<Header *>(n) - 1;
+  } else {
+    if (!chunks_ || chunks_->cap - chunks_->used < total) {
+      Chunk *c = new_chunk(kChunkSize);
+      c->next = chunks_;
+      chunks_ = c;
+    }
+    h = reinterpret_cast<Header *>(chunk_data(chunks_) + chunks_->used);
+    chunks_->used += total;
+  }
+  h->owner = this;
+  h->size_class = static_cast<uint32_t>(cls);
+  h->kind = kind;
+  return h + 1;
+}
+
+/*!
+ *@brief 回收对象空间
+ *@param p 对象地址
+ *@note
+ *----------
+ *由块头找到所属池；小对象挂入对应级别的空闲链表，
+ *大对象所在的大块从链表摘除后归还系统，逐个函数编译时不随函数数量累积
+ */
+void Arena::deallocate(void *p) {
+  if (!p) {
+    return;
+  }
+  Header *h = static_cast<Header *>(p) - 1;
+  Arena *a = h->owner;
+  std::lock_guard<std::mutex> guard(a->mutex_);
+  h->kind = kFreeBlock;
+  if (h->size_class != 0) {
+    FreeNode *n = static_cast<FreeNode *>(p);
+    n->next = a->free_[h->size_class];
+    a->free_[h->size_class] = n;
+    return;
+  }
+  Chunk *c = reinterpret_cast<Chunk *>(h) - 1;
+  if (c->prev) {
+    c->prev->next = c->next;
+  } else {
+    a->large_ = c->next;
+  }
+  if (c->next) {
+    c->next->prev = c->prev;
+  }
+  a->reserved_ -= sizeof(Chunk) + c->cap;
+  std::free(c);
+}
+
+/*!
+ *@brief 遍历所有未回收的对象
+ *@note
+ *----------
+ *各大块内的对象首尾相接，按块头的尺寸级别跳到下一个对象
+ */
+void Arena::for_each_live(void (*fn)(void *obj, ArenaKind kind)) {
+  for (Chunk *c = chunks_; c; c = c->next) {
+    char *p = chunk_data(c);
+    char *end = p + c->used;
+    while (p < end) {
+      Header *h = reinterpret_cast<Header *>(p);
+      p += h->size_class * kAlign;
+      if (h->kind != kFreeBlock) {
+        fn(h + 1, h->kind);
+      }
+    }
+  }
+  for (Chunk *c = large_; c; c = c->next) {
+    Header *h = reinterpret_cast<Header *>(chunk_data(c));
+    if (h->kind != kFreeBlock) {
+      fn(h + 1, h->kind);
+    }
+  }
+}
+
+/*!
+ *@brief 归还全部大块
+ */
+void Arena::release() {
+  for (Chunk *list : {chunks_, large_}) {
+    while (list) {
+      Chunk *next = list->next;
+      std::free(list);
+      list = next;
+    }
+  }
+  chunks_ = nullptr;
+  large_ = nullptr;
+  for (auto &f : free_) {
+    f = nullptr;
+  }
+  reserved_ = 0;
+}
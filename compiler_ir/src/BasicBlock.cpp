@@ -21,13 +21,27 @@
  *----------
  *默认基本块名称为label_()number
  *构建默认为真基本块，名称为空，类型为基本块
- *&emsp; 如果parent为空，创建失败，异常退出
+ *&emsp; 如果parent为空，创建游离的基本块，稍后通过insert_into挂入函数
  *&emsp; 向所属的函数中添加基本块指针
  */
 BasicBlock::BasicBlock(Module *m, const std::string &name = "",
                        Function *parent = nullptr, bool fake = false)
     : Value(Type::get_label_type(m), name), parent_(parent), _fake(fake) {
-  // assert(parent && "currently parent should not be nullptr");
+  if (parent_) {
+    parent_->add_basic_block(this);
+  }
+}
+
+/*!
+ *@brief 将游离的基本块追加到函数末尾
+ *@param parent 所从属的函数
+ *@note
+ *----------
+ *用于先创建跳转目标、在开始生成其内容时再确定块的排列位置
+ */
+void BasicBlock::insert_into(Function *parent) {
+  assert(!parent_ && "basic block already has a parent");
+  parent_ = parent;
   parent_->add_basic_block(this);
 }
 
@@ -36,25 +50,14 @@ BasicBlock::BasicBlock(Module *m, const std::string &name = "",
  *@param 待添加的指令指针
  *@note
  *----------
- *在基本块的尾部添加指令
- *&emsp; 设置待添加的指令后缀为空
- *&emsp; **if** 如果指令链表为空
- *&emsp;&emsp; 设置指令为后继为空
- *&emsp;&emsp; 不为空，则获取指令链表的最后一个指令
- *&emsp;&emsp; 设置插入指令的前继为最后一个指令
- *&emsp;&emsp; 最后一个指令后继为待插入指令
- *&emsp; 尾部插入指令
+ *在基本块的尾部添加指令，前后继指针由侵入式链表维护
+ *指令构造时经此挂入，跳转指令的出边由其构造函数建立
  */
 void BasicBlock::add_instruction(Instruction *instr) {
-  instr->setSuccInst(nullptr);
-  if (instr_list_.empty()) {
-    instr->setSuccInst(nullptr);
-  } else {
-    Instruction *last_inst = instr_list_.back();
-    instr->setPrevInst(last_inst);
-    last_inst->setSuccInst(instr);
-  }
   instr_list_.push_back(instr);
+  if (parent_) {
+    parent_->assign_number(instr);
+  }
 }
 
   /*!
@@ -80,24 +83,12 @@ void BasicBlock::add_instruction(Instruction *instr) {
  *@note
  *----------
  *在基本块的头部添加指令
- *&emsp; 设置待添加的指令前继为空
- *&emsp; **if** 如果指令链表为空
- *&emsp;&emsp; 设置指令为后继为空
- *&emsp;&emsp; 不为空，则获取指令链表的第一个指令
- *&emsp;&emsp; 设置插入指令的后继为第一个指令
- *&emsp;&emsp; 第一个指令前继为待插入指令
- *&emsp; 头部插入指令
  */
 void BasicBlock::add_instr_begin(Instruction *instr) {
-  instr->setPrevInst(nullptr);
-  if (instr_list_.empty()) {
-    instr->setSuccInst(nullptr);
-  } else {
-    Instruction *first_inst = instr_list_.front();
-    instr->setSuccInst(first_inst);
-    first_inst->setPrevInst(instr);
-  }
   instr_list_.push_front(instr);
+  if (parent_) {
+    parent_->assign_number(instr);
+  }
 }
 
 /*!
@@ -106,15 +97,10 @@ void BasicBlock::add_instr_begin(Instruction *instr) {
  *@note
  *----------
  *向phi指令后添加指令
- *&emsp; 设置指令的从属基本块
- *&emsp; 获取指令链表的开始
- *&emsp;&emsp; **for** 循环，遍历获得phi指令点
- *&emsp; **if** 如果不是链表头，phi节点前继为节点前继
- *&emsp; **if** 如果不是链表尾，phi节点后继设置为节点本身
- *&emsp; 修正插入节点的连接关系，前继和后继的修改
+ *&emsp; **for** 循环，遍历获得phi指令点
+ *&emsp; 在该位置插入
  */
 void BasicBlock::add_instr_after_phi(Instruction *instr) {
-  instr->set_parent(this);
   auto it = instr_list_.begin();
   //遍历获得phi指令点
   for (; it != instr_list_.end(); ++it) {
@@ -122,25 +108,101 @@ void BasicBlock::add_instr_after_phi(Instruction *instr) {
       break;
     }
   }
-  //获取插入点
-  Instruction *front = nullptr, *back = nullptr;
-  if (it != instr_list_.begin()) {
-    front = *(--it);
-    ++it;
+  insert_instr_at(it, instr);
+}
+
+/*!
+ *@brief 在开头的phi与alloca指令之后添加指令
+ *@param 待添加的指令指针
+ *@note
+ *----------
+ *用于把alloca集中到入口块开头
+ *&emsp; **for** 循环，跳过块首连续的phi和alloca指令
+ *&emsp; 在该位置插入，保持alloca按创建顺序排列
+ */
+void BasicBlock::add_instr_after_alloca(Instruction *instr) {
+  auto it = instr_list_.begin();
+  for (; it != instr_list_.end(); ++it) {
+    if (!(*it)->is_phi() && !(*it)->is_alloca()) {
+      break;
+    }
   }
-  if (it != instr_list_.end()) {
-    back = *it;
+  insert_instr_at(it, instr);
+}
+
+/*!
+ *@brief 在指令链表的指定位置之前插入指令
+ *@param it 插入位置
+ *@param instr 待插入的指令指针
+ *@note
+ *----------
+ *重新插入的跳转指令在此建立出边
+ */
+void BasicBlock::insert_instr_at(InstList::iterator it, Instruction *instr) {
+  instr->set_parent(this);
+  instr_list_.insert(it, instr);
+  if (parent_) {
+    parent_->assign_number(instr);
   }
-  if (front != nullptr) {
-    front->setSuccInst(instr);
+  if (instr->is_br()) {
+    static_cast<BranchInst *>(instr)->link_edges();
   }
-  if (back != nullptr) {
-    back->setPrevInst(instr);
+}
+
+/*!
+ *@brief 在指定指令之前插入指令
+ *@param pos 本块中的指令
+ *@param instr 待插入的指令指针
+ */
+void BasicBlock::insert_before(Instruction *pos, Instruction *instr) {
+  assert(pos->get_parent() == this && "insert position not in this block");
+  insert_instr_at(InstList::iterator(pos, &instr_list_), instr);
+}
+
+/*!
+ *@brief 在指定指令之后插入指令
+ *@param pos 本块中的指令
+ *@param instr 待插入的指令指针
+ */
+void BasicBlock::insert_after(Instruction *pos, Instruction *instr) {
+  assert(pos->get_parent() == this && "insert position not in this block");
+  insert_instr_at(InstList::iterator(pos->getSuccInst(), &instr_list_), instr);
+}
+
+/*!
+ *@brief 把src中从first起到块尾的指令整段移到本块末尾
+ *@param src 源基本块
+ *@param first src中的指令
+ *@note
+ *----------
+ *&emsp; 逐条修正所属块并计数
+ *&emsp; 跳转指令的出边起点随之改为本块
+ *&emsp; 跨函数移动时编号改由本块所属函数分配，同一函数内保持不变
+ *&emsp; 链表两端一次拼接
+ */
+void BasicBlock::splice_from(BasicBlock *src, Instruction *first) {
+  size_t count = 0;
+  bool rehome = src->parent_ != parent_;
+  for (Instruction *i = first; i != nullptr; i = i->getSuccInst()) {
+    if (i->is_br()) {
+      auto br = static_cast<BranchInst *>(i);
+      br->unlink_edges();
+      i->set_parent(this);
+      br->link_edges();
+    } else {
+      i->set_parent(this);
+    }
+    if (rehome) {
+      if (src->parent_) {
+        src->parent_->release_number(i);
+      }
+      if (parent_) {
+        parent_->assign_number(i);
+      }
+    }
+    count++;
   }
-  // 设置待插入节点的前后继
-  instr->setPrevInst(front);
-  instr->setSuccInst(back);
-  instr_list_.insert(it, instr);
+  instr_list_.splice_back(src->instr_list_, first, count);
 }
 
 /*!
@@ -148,28 +210,40 @@ void BasicBlock::add_instr_after_phi(Instruction *instr) {
  *@param 待删除的指令指针
  *@note
  *----------
- *&emsp; 删除维护的指令链表中的指令
- *&emsp; 获取删除的指令的前后指令
- *&emsp; 修正指令的链接关系：
- *&emsp; **if** 如果前置指令不为空
- *&emsp;&emsp; 为前置指令设置新的后置指令
- *&emsp; **if** 如果后置指令不为空
- *&emsp;&emsp; 为后置指令设置新的前置指令
- *&emsp; 被删除的指令进行相关use的删除
+ *&emsp; 从侵入式指令链表摘除，O(1)
+ *&emsp; 跳转指令先撤销其出边
+ *&emsp; 被删除的指令进行相关use的删除，收回其编号
+ *&emsp; 释放指令，调用者不可再使用该指针
  */
 void BasicBlock::delete_instr(Instruction *instr) {
-  instr_list_.remove(instr);
-  Instruction *prev = instr->getPrevInst();
-  Instruction *succ = instr->getSuccInst();
-  //修正指令的链接关系
-  if (prev != nullptr) {
-    prev->setSuccInst(succ);
+  if (instr->is_br()) {
+    static_cast<BranchInst *>(instr)->unlink_edges();
   }
-  if (succ != nullptr) {
-    succ->setPrevInst(prev);
+  instr_list_.remove(instr);
+  if (parent_) {
+    parent_->release_number(instr);
   }
-  //被删除的指令进行相关use的删除
+  //被删除的指令进行相关use的删除，空间归还内存池
   instr->remove_use_of_ops();
+  delete instr;
+}
+
+/*!
+ *@brief 从本块摘除指令但保留其操作数
+ *@param instr 待摘除的指令指针
+ *@note
+ *----------
+ *跳转指令的出边一并撤销，重新插入某块时再建立
+ */
+void BasicBlock::remove_instr(Instruction *instr) {
+  if (instr->is_br()) {
+    static_cast<BranchInst *>(instr)->unlink_edges();
+  }
+  instr_list_.remove(instr);
+  if (parent_) {
+    parent_->release_number(instr);
+  }
+  instr->set_parent(nullptr);
 }
 
 /*!
@@ -206,58 +280,103 @@ const Instruction *BasicBlock::get_terminator() const {
   }
 }
 
+/*!
+ *@brief 返回基本块的后置基本块
+ *@return 后置基本块表
+ *@note
+ *----------
+ *&emsp; 终结指令为跳转时，依次取其各个目标
+ *&emsp; 否则没有后继
+ */
+SuccList BasicBlock::get_succ_basic_blocks() {
+  SuccList succs;
+  Instruction *term = get_terminator();
+  if (term && term->is_br()) {
+    auto br = static_cast<BranchInst *>(term);
+    for (unsigned i = 0; i < br->get_num_successors(); i++) {
+      succs.push_back(br->get_successor(i));
+    }
+  }
+  return succs;
+}
+
+/*!
+ *@brief 向前置基本块表中加入一条入边
+ *@param bb 入边的起点
+ *@note
+ *----------
+ *游离块的入边在挂入函数时随块一并计入 CFG 的改变
+ */
+void BasicBlock::add_pre_basic_block(BasicBlock *bb) {
+  pre_bbs_.push_back(bb);
+  if (parent_) {
+    parent_->invalidate_cfg();
+  }
+}
+
+/*!
+ *@brief 删除前置基本块表中的一条入边
+ *@param bb 入边的起点
+ */
+void BasicBlock::remove_pre_basic_block(BasicBlock *bb) {
+  for (auto it = pre_bbs_.begin(); it != pre_bbs_.end(); ++it) {
+    if (*it == bb) {
+      pre_bbs_.erase(it);
+      if (parent_) {
+        parent_->invalidate_cfg();
+      }
+      return;
+    }
+  }
+  assert(false && "no such predecessor");
+}
+
 /*!
  *@brief 打印基本块
- *@return 待打印的字符串
+ *@param os 输出流
  *@note
  *----------
- *return parent, or null if none.
- *&emsp; 如果基本块为假，那么输出空
- *&emsp; 定义输出字符串string
+ *&emsp; 如果基本块为假，那么不输出
  *&emsp; 添加基本块名称，
  *&emsp; 添加前置基本块的说明，依次打印前置基本块
  *&emsp; 隶属于函数则进行空行添加
  *&emsp; 依次打印维护的指令链表内容
  *&emsp; 如果基本块无终结指令，默认添加
  */
-std::string BasicBlock::print() {
+void BasicBlock::print(IROStream &os) {
   if (_fake) {
-    return "";
+    return;
   }
-  std::string bb_ir;
-  bb_ir += this->get_name();
-  bb_ir += ":";
+  print_name(os, this);
+  os << ':';
   // print prebb
   if (!this->get_pre_basic_blocks().empty()) {
-    bb_ir += "                                                ; preds = ";
+    os << "                                                ; preds = ";
   }
   for (auto bb : this->get_pre_basic_blocks()) {
     if (bb != *this->get_pre_basic_blocks().begin())
-      bb_ir += ", ";
-    bb_ir += print_as_op(bb, false);
+      os << ", ";
+    print_as_op(os, bb, false);
   }
 
   // print func
   if (!this->get_parent()) {
-    bb_ir += "\n";
-    bb_ir += "; Error: Block without parent!";
+    os << "\n; Error: Block without parent!";
   }
-  bb_ir += "\n";
+  os << '\n';
   for (auto instr : this->get_instructions()) {
-    bb_ir += "  ";
-    bb_ir += instr->print();
-    bb_ir += "\n";
+    os << "  ";
+    instr->print(os);
+    os << '\n';
   }
 
   // 空BasicBlock，自动加上return语句
   if (get_terminator() == nullptr) {
-    bb_ir += "  ";
+    os << "  ";
     if (get_parent()->get_return_type()->is_void_type()) {
-      bb_ir += "ret void\n";
+      os << "ret void\n";
     } else {
-      bb_ir += "ret i32 0\n";
+      os << "ret i32 0\n";
     }
   }
-
-  return bb_ir;
 }
\ No newline at end of file
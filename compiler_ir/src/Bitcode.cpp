@@ -0,0 +1,887 @@
+/*!
+ *@file Bitcode.cpp
+ *@brief 模块二进制格式读写定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "Bitcode.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "GlobalVariable.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Type.h"
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const char kMagic[4] = {'S', 'Y', 'B', 'C'};
+constexpr uint64_t kVersion = 2;
+
+/// 常量表中的记录种类
+enum ConstKind : uint64_t { kConstInt, kConstFloat, kConstZero, kConstArray };
+
+/// LEB128 编码输出
+class ByteWriter {
+public:
+  void u(uint64_t v) {
+    while (v >= 0x80) {
+      out_.push_back(static_cast<char>(v | 0x80));
+      v >>= 7;
+    }
+    out_.push_back(static_cast<char>(v));
+  }
+  /// 有符号数先做 zigzag 变换，绝对值小的负数也只占一个字节
+  void s(int64_t v) {
+    u((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+  }
+  void str(const std::string &v) {
+    u(v.size());
+    out_.append(v);
+  }
+  void append(const ByteWriter &o) { out_ += o.out_; }
+  size_t size() const { return out_.size(); }
+  std::string take() { return std::move(out_); }
+
+private:
+  std::string out_;
+};
+
+/// LEB128 解码输入，越界后 ok() 为 false，之后读出的值均为 0
+class ByteReader {
+public:
+  ByteReader(const uint8_t *p, const uint8_t *end) : p_(p), end_(end) {}
+  uint64_t u() {
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      if (p_ == end_) {
+        break;
+      }
+      uint8_t b = *p_++;
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80)) {
+        return v;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+  int64_t s() {
+    uint64_t v = u();
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+  }
+  std::string str() {
+    uint64_t n = u();
+    if (n > static_cast<uint64_t>(end_ - p_)) {
+      ok_ = false;
+      return "";
+    }
+    std::string v(reinterpret_cast<const char *>(p_), n);
+    p_ += n;
+    return v;
+  }
+  /// 元素个数：每个元素至少占一个字节，超过剩余字节数的视为损坏，返回 0
+  uint64_t count() {
+    uint64_t n = u();
+    if (n > static_cast<uint64_t>(end_ - p_)) {
+      ok_ = false;
+      return 0;
+    }
+    return n;
+  }
+  bool ok() const { return ok_; }
+  bool at_end() const { return p_ == end_; }
+  const uint8_t *cur() const { return p_; }
+
+private:
+  const uint8_t *p_;
+  const uint8_t *end_;
+  bool ok_ = true;
+};
+
+/// 模块编码器，见 write_bitcode
+class ModuleWriter {
+public:
+  explicit ModuleWriter(Module *m) : m_(m) {}
+  std::string write();
+
+private:
+  uint64_t string_id(Value *v);
+  uint64_t type_id(Type *ty);
+  void add_constant(Constant *c);
+  void write_body(Function *f, ByteWriter &w);
+
+  Module *m_;
+  std::unordered_map<const std::string *, uint64_t> string_ids_;
+  std::vector<const std::string *> strings_;
+  std::unordered_map<Type *, uint64_t> type_ids_;
+  ByteWriter types_;
+  std::vector<Constant *> constants_;
+  std::unordered_map<Value *, uint64_t> ids_;
+};
+
+/*!
+ *@brief 名称在字符串表中的下标+1，未命名为 0
+ *@note 名称已在模块中驻留，按地址去重
+ */
+uint64_t ModuleWriter::string_id(Value *v) {
+  if (!v->has_name()) {
+    return 0;
+  }
+  const std::string *name = &v->get_name();
+  auto it = string_ids_.find(name);
+  if (it != string_ids_.end()) {
+    return it->second;
+  }
+  strings_.push_back(name);
+  string_ids_.emplace(name, strings_.size());
+  return strings_.size();
+}
+
+/*!
+ *@brief 类型在类型表中的下标，首次出现时先登记其子类型
+ */
+uint64_t ModuleWriter::type_id(Type *ty) {
+  auto it = type_ids_.find(ty);
+  if (it != type_ids_.end()) {
+    return it->second;
+  }
+  ByteWriter rec;
+  rec.u(ty->get_type_id());
+  switch (ty->get_type_id()) {
+  case Type::PointerTyID:
+    rec.u(type_id(static_cast<PointerType *>(ty)->get_element_type()));
+    break;
+  case Type::ArrayTyID: {
+    auto arr = static_cast<ArrayType *>(ty);
+    rec.u(type_id(arr->get_element_type()));
+    rec.u(arr->get_num_of_elements());
+    break;
+  }
+  case Type::FunctionTyID: {
+    auto fty = static_cast<FunctionType *>(ty);
+    rec.u(type_id(fty->get_return_type()));
+    rec.u(fty->get_num_of_args());
+    for (unsigned i = 0; i < fty->get_num_of_args(); i++) {
+      rec.u(type_id(fty->get_param_type(i)));
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  types_.append(rec);
+  uint64_t id = type_ids_.size();
+  type_ids_.emplace(ty, id);
+  return id;
+}
+
+/*!
+ *@brief 登记常量，数组元素先于数组本身
+ */
+void ModuleWriter::add_constant(Constant *c) {
+  if (ids_.count(c)) {
+    return;
+  }
+  if (auto arr = dynamic_cast<ConstantArray *>(c)) {
+    for (unsigned i = 0; i < arr->get_size_of_array(); i++) {
+      add_constant(arr->get_element_value(i));
+    }
+  }
+  ids_.emplace(c, constants_.size());
+  constants_.push_back(c);
+}
+
+/*!
+ *@brief 编码一个函数体
+ *@note
+ *----------
+ *先为参数、基本块、指令依次编号，使前向引用（回边上的phi、
+ *后续块中的定值）也能写成相对编号
+ */
+void ModuleWriter::write_body(Function *f, ByteWriter &w) {
+  uint64_t id = ids_.size();
+  std::unordered_map<Value *, uint64_t> locals;
+  for (auto arg : f->get_args()) {
+    locals.emplace(arg, id++);
+  }
+  uint64_t block_base = id;
+  for (auto bb : f->get_basic_blocks()) {
+    locals.emplace(bb, id++);
+  }
+  for (auto bb : f->get_basic_blocks()) {
+    for (auto instr : bb->get_instructions()) {
+      locals.emplace(instr, id++);
+    }
+  }
+  auto value_id = [&](Value *v) {
+    auto it = locals.find(v);
+    if (it != locals.end()) {
+      return it->second;
+    }
+    auto git = ids_.find(v);
+    assert(git != ids_.end() && "operand is not part of the module");
+    return git->second;
+  };
+
+  for (auto arg : f->get_args()) {
+    w.u(string_id(arg));
+  }
+  w.u(f->get_num_basic_blocks());
+  for (auto bb : f->get_basic_blocks()) {
+    w.u(string_id(bb));
+    w.u(bb->is_fake_block());
+    w.u(bb->get_pre_basic_blocks().size());
+    for (auto pre : bb->get_pre_basic_blocks()) {
+      w.u(value_id(pre) - block_base);
+    }
+  }
+  for (auto bb : f->get_basic_blocks()) {
+    w.u(bb->get_instructions().size());
+    for (auto instr : bb->get_instructions()) {
+      int64_t cur = static_cast<int64_t>(value_id(instr));
+      w.u(instr->get_instr_type());
+      w.u(type_id(instr->get_type()));
+      w.u(string_id(instr));
+      w.u(instr->get_num_operand());
+      for (auto op : instr->get_operands()) {
+        w.s(cur - static_cast<int64_t>(value_id(op)));
+      }
+      if (auto cmp = dynamic_cast<CmpInst *>(instr)) {
+        w.u(cmp->get_cmp_op());
+      } else if (auto alloca = dynamic_cast<AllocaInst *>(instr)) {
+        w.u(type_id(alloca->get_alloca_type()));
+      }
+    }
+  }
+}
+
+/*!
+ *@brief 编码整个模块
+ *@note
+ *----------
+ *先扫描全局量初值与指令操作数登记全部常量，确定全局 value 的编号；
+ *函数体先写入各自的缓冲，类型表在其间逐步补全，最后按格式顺序拼接
+ */
+std::string ModuleWriter::write() {
+  for (auto gv : m_->get_global_variable()) {
+    if (gv->get_init()) {
+      add_constant(gv->get_init());
+    }
+  }
+  for (auto f : m_->get_functions()) {
+    for (auto bb : f->get_basic_blocks()) {
+      for (auto instr : bb->get_instructions()) {
+        for (auto op : instr->get_operands()) {
+          if (auto c = dynamic_cast<Constant *>(op)) {
+            add_constant(c);
+          }
+        }
+      }
+    }
+  }
+  for (auto gv : m_->get_global_variable()) {
+    ids_.emplace(gv, ids_.size());
+  }
+  for (auto f : m_->get_functions()) {
+    ids_.emplace(f, ids_.size());
+  }
+
+  ByteWriter consts;
+  for (auto c : constants_) {
+    if (auto ci = dynamic_cast<ConstantInt *>(c)) {
+      consts.u(kConstInt);
+      consts.u(type_id(c->get_type()));
+      consts.s(ci->get_value());
+    } else if (auto cf = dynamic_cast<ConstantFloat *>(c)) {
+      float v = cf->get_value();
+      uint32_t bits;
+      std::memcpy(&bits, &v, sizeof(bits));
+      consts.u(kConstFloat);
+      consts.u(type_id(c->get_type()));
+      consts.u(bits);
+    } else if (dynamic_cast<ConstantZero *>(c)) {
+      consts.u(kConstZero);
+      consts.u(type_id(c->get_type()));
+    } else {
+      auto arr = static_cast<ConstantArray *>(c);
+      consts.u(kConstArray);
+      consts.u(type_id(c->get_type()));
+      consts.u(arr->get_size_of_array());
+      for (unsigned i = 0; i < arr->get_size_of_array(); i++) {
+        consts.u(ids_.at(arr->get_element_value(i)));
+      }
+    }
+  }
+
+  ByteWriter globals;
+  globals.u(m_->get_global_variable().size());
+  for (auto gv : m_->get_global_variable()) {
+    globals.u(string_id(gv));
+    globals.u(type_id(gv->get_type()->get_pointer_element_type()));
+    globals.u(gv->is_const());
+    globals.u(gv->get_init() ? ids_.at(gv->get_init()) + 1 : 0);
+    auto flat = gv->getFlattenInit();
+    globals.u(flat.size());
+    for (int v : flat) {
+      globals.s(v);
+    }
+  }
+
+  ByteWriter funcs;
+  ByteWriter bodies;
+  funcs.u(m_->get_functions().size());
+  for (auto f : m_->get_functions()) {
+    ByteWriter body;
+    if (!f->is_declaration()) {
+      write_body(f, body);
+    }
+    funcs.u(string_id(f));
+    funcs.u(type_id(f->get_type()));
+    funcs.u(body.size());
+    bodies.append(body);
+  }
+
+  ByteWriter out;
+  for (char ch : kMagic) {
+    out.u(static_cast<uint8_t>(ch));
+  }
+  out.u(kVersion);
+  out.u(strings_.size());
+  for (auto s : strings_) {
+    out.str(*s);
+  }
+  out.u(type_ids_.size());
+  out.append(types_);
+  out.u(constants_.size());
+  out.append(consts);
+  out.append(globals);
+  out.append(funcs);
+  out.append(bodies);
+  return out.take();
+}
+} // namespace
+
+std::string write_bitcode(Module *m) { return ModuleWriter(m).write(); }
+
+bool write_bitcode_file(Module *m, const std::string &path) {
+  std::string data = write_bitcode(m);
+  std::ofstream out(path, std::ios::binary);
+  out.write(data.data(), data.size());
+  return static_cast<bool>(out);
+}
+
+BitcodeReader::~BitcodeReader() { unmap(); }
+
+void BitcodeReader::unmap() {
+#ifndef _WIN32
+  if (mapped_) {
+    munmap(mapped_, size_);
+  }
+#endif
+  mapped_ = nullptr;
+  owned_.clear();
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool BitcodeReader::fail(const std::string &msg) {
+  error_ = msg;
+  return false;
+}
+
+/*!
+ *@brief 映射文件
+ *@note 不支持 mmap 的平台上整体读入内存
+ */
+bool BitcodeReader::open(const std::string &path) {
+  unmap();
+#ifdef _WIN32
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return fail("cannot open " + path);
+  }
+  owned_.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  data_ = reinterpret_cast<const uint8_t *>(owned_.data());
+  size_ = owned_.size();
+#else
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return fail("cannot open " + path);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return fail("cannot read " + path);
+  }
+  void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    return fail("cannot map " + path);
+  }
+  mapped_ = p;
+  data_ = static_cast<const uint8_t *>(p);
+  size_ = st.st_size;
+#endif
+  return true;
+}
+
+void BitcodeReader::set_buffer(const char *data, size_t size) {
+  unmap();
+  data_ = reinterpret_cast<const uint8_t *>(data);
+  size_ = size;
+}
+
+/*!
+ *@brief 重建类型、常量、全局变量与函数声明
+ *@note
+ *----------
+ *各表的记录只引用排在前面的记录，顺序建立即可；
+ *函数体的位置由函数表中各函数体的字节数累加得到
+ */
+bool BitcodeReader::read_module(Module *m, bool lazy) {
+  if (!data_) {
+    return fail("no input");
+  }
+  module_ = m;
+  ByteReader r(data_, data_ + size_);
+  for (char ch : kMagic) {
+    if (r.u() != static_cast<uint8_t>(ch)) {
+      return fail("not a bitcode file");
+    }
+  }
+  if (r.u() != kVersion) {
+    return fail("unsupported bitcode version");
+  }
+
+  strings_.assign(1, "");
+  for (uint64_t n = r.u(); n && r.ok(); n--) {
+    strings_.push_back(r.str());
+  }
+  auto name = [&](uint64_t id) -> const std::string & {
+    return id < strings_.size() ? strings_[id] : strings_[0];
+  };
+  auto type = [&](uint64_t id) -> Type * {
+    return id < types_.size() ? types_[id] : nullptr;
+  };
+
+  for (uint64_t n = r.u(); n && r.ok(); n--) {
+    Type *ty = nullptr;
+    switch (r.u()) {
+    case Type::VoidTyID:
+      ty = m->get_void_type();
+      break;
+    case Type::LabelTyID:
+      ty = m->get_label_type();
+      break;
+    case Type::IntegerTy1ID:
+      ty = m->get_int1_type();
+      break;
+    case Type::IntegerTy32ID:
+      ty = m->get_int32_type();
+      break;
+    case Type::FloatTyID:
+      ty = m->get_float_type();
+      break;
+    case Type::PointerTyID:
+      if (Type *elem = type(r.u())) {
+        ty = PointerType::get(elem);
+      }
+      break;
+    case Type::ArrayTyID:
+      if (Type *elem = type(r.u())) {
+        if (ArrayType::is_valid_element_type(elem)) {
+          ty = ArrayType::get(elem, r.u());
+        }
+      }
+      break;
+    case Type::FunctionTyID: {
+      Type *result = type(r.u());
+      std::vector<Type *> params(r.count());
+      for (auto &p : params) {
+        p = type(r.u());
+        if (!p || !FunctionType::is_valid_argument_type(p)) {
+          return fail("bad function parameter type");
+        }
+      }
+      if (result && FunctionType::is_valid_return_type(result) && r.ok()) {
+        ty = FunctionType::get(result, params);
+      }
+      break;
+    }
+    default:
+      break;
+    }
+    if (!ty) {
+      return fail("bad type record");
+    }
+    types_.push_back(ty);
+  }
+
+  for (uint64_t n = r.u(); n && r.ok(); n--) {
+    uint64_t kind = r.u();
+    Type *ty = type(r.u());
+    Constant *c = nullptr;
+    if (!ty) {
+      return fail("bad constant type");
+    }
+    if (kind == kConstInt && ty->is_integer_type()) {
+      c = m->get_constant_int(static_cast<IntegerType *>(ty),
+                              static_cast<int>(r.s()));
+    } else if (kind == kConstFloat) {
+      uint32_t bits = static_cast<uint32_t>(r.u());
+      float v;
+      std::memcpy(&v, &bits, sizeof(v));
+      c = ConstantFloat::get(v, m);
+    } else if (kind == kConstZero) {
+      c = ConstantZero::get(ty, m);
+    } else if (kind == kConstArray && ty->is_array_type()) {
+      std::vector<Constant *> elems(r.count());
+      for (auto &e : elems) {
+        uint64_t id = r.u();
+        e = id < globals_.size() ? static_cast<Constant *>(globals_[id])
+                                 : nullptr;
+        if (!e) {
+          return fail("bad array element");
+        }
+      }
+      if (!r.ok()) {
+        return fail("truncated bitcode");
+      }
+      c = ConstantArray::get(static_cast<ArrayType *>(ty), elems);
+    }
+    if (!c) {
+      return fail("bad constant record");
+    }
+    globals_.push_back(c);
+  }
+  size_t num_constants = globals_.size();
+
+  for (uint64_t n = r.u(); n && r.ok(); n--) {
+    const std::string &gname = name(r.u());
+    Type *ty = type(r.u());
+    bool is_const = r.u() != 0;
+    uint64_t init = r.u();
+    if (!ty || init == 0 || init > num_constants) {
+      return fail("bad global variable record");
+    }
+    auto gv = GlobalVariable::create(
+        gname, m, ty, is_const,
+        static_cast<Constant *>(globals_[init - 1]));
+    std::vector<int> flat(r.count());
+    for (auto &v : flat) {
+      v = static_cast<int>(r.s());
+    }
+    gv->setFlattenInit(flat);
+    globals_.push_back(gv);
+  }
+
+  std::vector<std::pair<Function *, uint64_t>> funcs;
+  for (uint64_t n = r.u(); n && r.ok(); n--) {
+    const std::string &fname = name(r.u());
+    Type *ty = type(r.u());
+    if (!ty || !ty->is_function_type()) {
+      return fail("bad function record");
+    }
+    auto f = Function::create(static_cast<FunctionType *>(ty), fname, m);
+    funcs.emplace_back(f, r.u());
+    globals_.push_back(f);
+  }
+  if (!r.ok()) {
+    return fail("truncated bitcode");
+  }
+
+  size_t offset = r.cur() - data_;
+  for (auto &fn : funcs) {
+    if (fn.second > size_ - offset) {
+      return fail("truncated function body");
+    }
+    if (fn.second) {
+      bodies_[fn.first] = BodyRange{offset, fn.second, false};
+    }
+    offset += fn.second;
+  }
+  return lazy || materialize_all();
+}
+
+bool BitcodeReader::materialize(Function *f) {
+  auto it = bodies_.find(f);
+  if (it == bodies_.end() || it->second.done) {
+    return true;
+  }
+  it->second.done = true;
+  return read_body(f, it->second);
+}
+
+bool BitcodeReader::materialize_all() {
+  for (auto f : module_->get_functions()) {
+    if (!materialize(f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BitcodeReader::is_materialized(Function *f) const {
+  auto it = bodies_.find(f);
+  return it == bodies_.end() || it->second.done;
+}
+
+/*!
+ *@brief 解码一个函数体
+ *@note
+ *----------
+ *&emsp; 先建立全部基本块，再把指令记录整体解码，得到每条指令的类型
+ *&emsp; 按顺序用各指令的创建函数重建；引用尚未重建的指令时先用同类型的
+ *&emsp; 占位value代替，指令建成后把占位value的使用者全部改挂过来
+ *&emsp; 跳转指令创建时建立前驱，最后按记录恢复原来的顺序
+ */
+bool BitcodeReader::read_body(Function *f, BodyRange &range) {
+  Module *m = module_;
+  ByteReader r(data_ + range.offset, data_ + range.offset + range.size);
+  const uint64_t base = globals_.size();
+  std::vector<Value *> locals;
+  for (auto arg : f->get_args()) {
+    uint64_t id = r.u();
+    if (id && id < strings_.size()) {
+      arg->set_name(strings_[id]);
+    }
+    locals.push_back(arg);
+  }
+
+  struct BlockRec {
+    BasicBlock *bb;
+    std::vector<uint64_t> preds;
+  };
+  std::vector<BlockRec> blocks(r.count());
+  for (auto &rec : blocks) {
+    uint64_t id = r.u();
+    bool fake = r.u() != 0;
+    rec.bb = BasicBlock::create(
+        m, id < strings_.size() ? strings_[id] : strings_[0], f, fake);
+    rec.preds.resize(r.count());
+    for (auto &p : rec.preds) {
+      p = r.u();
+    }
+    locals.push_back(rec.bb);
+    if (!r.ok()) {
+      return fail("truncated function body");
+    }
+  }
+
+  struct InstRec {
+    Instruction::OpID op;
+    Type *ty;
+    uint64_t name;
+    uint64_t extra;
+    size_t block;
+    std::vector<uint64_t> ops; //!< 绝对编号
+  };
+  const uint64_t inst_base = base + locals.size();
+  std::vector<InstRec> insts;
+  for (size_t b = 0; b < blocks.size() && r.ok(); b++) {
+    for (uint64_t n = r.u(); n && r.ok(); n--) {
+      InstRec rec;
+      int64_t cur = static_cast<int64_t>(inst_base + insts.size());
+      rec.op = static_cast<Instruction::OpID>(r.u());
+      uint64_t ty = r.u();
+      rec.ty = ty < types_.size() ? types_[ty] : nullptr;
+      rec.name = r.u();
+      rec.ops.resize(r.count());
+      for (auto &op : rec.ops) {
+        op = static_cast<uint64_t>(cur - r.s());
+      }
+      rec.extra = 0;
+      if (rec.op == Instruction::cmp || rec.op == Instruction::alloca) {
+        rec.extra = r.u();
+      }
+      rec.block = b;
+      if (!rec.ty) {
+        return fail("bad instruction type");
+      }
+      insts.push_back(std::move(rec));
+    }
+  }
+  if (!r.ok() || !r.at_end()) {
+    return fail("malformed function body");
+  }
+  const uint64_t end = inst_base + insts.size();
+  for (auto &rec : insts) {
+    for (auto op : rec.ops) {
+      if (op >= end) {
+        return fail("operand out of range");
+      }
+    }
+  }
+
+  std::vector<Value *> placeholders(insts.size(), nullptr);
+  auto value = [&](uint64_t id) -> Value * {
+    if (id < base) {
+      return globals_[id];
+    }
+    if (id - base < locals.size()) {
+      return locals[id - base];
+    }
+    Value *&ph = placeholders[id - inst_base];
+    if (!ph) {
+      ph = new (m) Value(insts[id - inst_base].ty);
+    }
+    return ph;
+  };
+  auto block = [&](uint64_t id) {
+    return dynamic_cast<BasicBlock *>(value(id));
+  };
+
+  for (size_t k = 0; k < insts.size(); k++) {
+    InstRec &rec = insts[k];
+    BasicBlock *bb = blocks[rec.block].bb;
+    std::vector<Value *> ops;
+    for (auto id : rec.ops) {
+      ops.push_back(value(id));
+    }
+    bool is_float = rec.ty->is_float_type();
+    Instruction *inst = nullptr;
+    switch (rec.op) {
+    case Instruction::ret:
+      inst = ops.empty() ? ReturnInst::create_void_ret(bb)
+                         : ReturnInst::create_ret(ops[0], bb);
+      break;
+    case Instruction::br:
+      if (ops.size() == 1 && block(rec.ops[0])) {
+        inst = BranchInst::create_br(block(rec.ops[0]), bb);
+      } else if (ops.size() == 3 && block(rec.ops[1]) && block(rec.ops[2])) {
+        inst = BranchInst::create_cond_br(ops[0], block(rec.ops[1]),
+                                          block(rec.ops[2]), bb);
+      }
+      break;
+    case Instruction::add:
+    case Instruction::sub:
+    case Instruction::mul:
+    case Instruction::sdiv:
+    case Instruction::mod:
+      if (ops.size() != 2) {
+        break;
+      }
+      if (rec.op == Instruction::add) {
+        inst = is_float ? BinaryInst::create_fadd(ops[0], ops[1], bb, m)
+                        : BinaryInst::create_add(ops[0], ops[1], bb, m);
+      } else if (rec.op == Instruction::sub) {
+        inst = is_float ? BinaryInst::create_fsub(ops[0], ops[1], bb, m)
+                        : BinaryInst::create_sub(ops[0], ops[1], bb, m);
+      } else if (rec.op == Instruction::mul) {
+        inst = is_float ? BinaryInst::create_fmul(ops[0], ops[1], bb, m)
+                        : BinaryInst::create_mul(ops[0], ops[1], bb, m);
+      } else if (rec.op == Instruction::sdiv) {
+        inst = is_float ? BinaryInst::create_fdiv(ops[0], ops[1], bb, m)
+                        : BinaryInst::create_sdiv(ops[0], ops[1], bb, m);
+      } else if (!is_float) {
+        inst = BinaryInst::create_mod(ops[0], ops[1], bb, m);
+      }
+      break;
+    case Instruction::cmp:
+      if (ops.size() == 2 && rec.extra <= CmpInst::LE) {
+        inst = CmpInst::create_cmp(static_cast<CmpInst::CmpOp>(rec.extra),
+                                   ops[0], ops[1], bb, m);
+      }
+      break;
+    case Instruction::alloca:
+      if (ops.empty() && rec.extra < types_.size()) {
+        inst = AllocaInst::create_alloca(types_[rec.extra], bb);
+      }
+      break;
+    case Instruction::load:
+      if (ops.size() == 1 && ops[0]->get_type()->is_pointer_type()) {
+        inst = LoadInst::create_load(rec.ty, ops[0], bb);
+      }
+      break;
+    case Instruction::store:
+      if (ops.size() == 2) {
+        inst = StoreInst::create_store(ops[0], ops[1], bb);
+      }
+      break;
+    case Instruction::phi:
+      if (ops.size() % 2 == 0) {
+        auto phi = PhiInst::create_phi(rec.ty, bb);
+        bb->add_instruction(phi);
+        for (size_t i = 0; i < ops.size(); i += 2) {
+          phi->add_phi_pair_operand(ops[i], ops[i + 1]);
+        }
+        inst = phi;
+      }
+      break;
+    case Instruction::call: {
+      auto callee = ops.empty() ? nullptr : dynamic_cast<Function *>(ops[0]);
+      if (callee && callee->get_num_of_args() == ops.size() - 1) {
+        inst = CallInst::create(
+            callee, std::vector<Value *>(ops.begin() + 1, ops.end()), bb);
+      }
+      break;
+    }
+    case Instruction::getelementptr:
+      if (!ops.empty() && ops[0]->get_type()->is_pointer_type()) {
+        inst = GetElementPtrInst::create_gep(
+            ops[0], std::vector<Value *>(ops.begin() + 1, ops.end()), bb);
+      }
+      break;
+    case Instruction::zext:
+      if (ops.size() == 1) {
+        inst = ZextInst::create_zext(ops[0], rec.ty, bb);
+      }
+      break;
+    case Instruction::fptosi:
+      if (ops.size() == 1) {
+        inst = FpToSiInst::create_fptosi(ops[0], rec.ty, bb);
+      }
+      break;
+    case Instruction::sitofp:
+      if (ops.size() == 1) {
+        inst = SiToFpInst::create_sitofp(ops[0], rec.ty, bb);
+      }
+      break;
+    default:
+      break;
+    }
+    if (!inst) {
+      return fail("bad instruction record");
+    }
+    if (rec.name && rec.name < strings_.size()) {
+      inst->set_name(strings_[rec.name]);
+    }
+    if (Value *ph = placeholders[k]) {
+      ph->replace_all_use_with(inst);
+      delete ph;
+      placeholders[k] = nullptr;
+    }
+    locals.push_back(inst);
+  }
+
+  // 前驱由跳转指令建立，这里只恢复其排列顺序
+  for (auto &rec : blocks) {
+    auto &preds = rec.bb->get_pre_basic_blocks();
+    if (rec.preds.size() != preds.size()) {
+      return fail("predecessors do not match branches");
+    }
+    preds.clear();
+    for (auto p : rec.preds) {
+      if (p >= blocks.size()) {
+        return fail("bad predecessor");
+      }
+      preds.push_back(blocks[p].bb);
+    }
+  }
+  return true;
+}
@@ -12,10 +12,10 @@
  *@brief 常量整数类32位创建函数
  *@param val 常量值
  *@param m 所属模块
- *@return 常量类对象指针
+ *@return 常量类对象指针，取自模块的常量池，同值共享
  */
 ConstantInt *ConstantInt::get(int val, Module *m) {
-  return new ConstantInt(Type::get_int32_type(m), val);
+  return m->get_constant_int(m->get_int32_type(), val);
 }
 /*!
  *@brief 常量整数类1位创建函数
@@ -24,7 +24,7 @@ ConstantInt *ConstantInt::get(int val, Module *m) {
  *@return 常量类对象指针
  */
 ConstantInt *ConstantInt::get(bool val, Module *m) {
-  return new ConstantInt(Type::get_int1_type(m), val ? 1 : 0);
+  return m->get_constant_int(m->get_int1_type(), val ? 1 : 0);
 }
 /*!
  *@brief 打印常量类变量
@@ -38,18 +38,16 @@ ConstantInt *ConstantInt::get(bool val, Module *m) {
  *&emsp; 将其数组转换为字符串输出
  *&emsp; 返回字符串
  */
-std::string ConstantInt::print() {
-  std::string const_ir;
+void ConstantInt::print(IROStream &os) {
   Type *ty = this->get_type();
   if (ty->is_integer_type() &&
       static_cast<IntegerType *>(ty)->get_num_bits() == 1) {
     // int1
-    const_ir += (this->get_value() == 0) ? "false" : "true";
+    os << ((this->get_value() == 0) ? "false" : "true");
   } else {
     // int32
-    const_ir += std::to_string(this->get_value());
+    os << this->get_value();
   }
-  return const_ir;
 }
 
 /*!
@@ -83,26 +81,24 @@ Constant *ConstantArray::get_element_value(int index) {
  */
 ConstantArray *ConstantArray::get(ArrayType *ty,
                                   const std::vector<Constant *> &val) {
-  return new ConstantArray(ty, val);
+  return new (ty->get_module()) ConstantArray(ty, val);
 }
 /*!
  *@brief 常量数组类打印函数
  *@return 字符串
  *constant int array
  */
-std::string ConstantArray::print() {
-  std::string const_ir;
-  const_ir += "[";
+void ConstantArray::print(IROStream &os) {
+  os << "[";
   for (int i = 0; i < static_cast<int>(this->get_size_of_array()); i++) {
-    const_ir += get_element_value(i)->get_type()->print();
-    const_ir += " ";
-    const_ir += get_element_value(i)->print();
-    const_ir += ", ";
+    if (i) {
+      os << ", ";
+    }
+    os << get_element_value(i)->get_type()->print();
+    os << " ";
+    get_element_value(i)->print(os);
   }
-  const_ir.pop_back();
-  const_ir.pop_back();
-  const_ir += "]";
-  return const_ir;
+  os << "]";
 }
 /*!
  *@brief 常量整数类构造函数
@@ -112,22 +108,22 @@ std::string ConstantArray::print() {
  *constant int zero
  */
 ConstantZero *ConstantZero::get(Type *ty, Module *m) {
-  return new ConstantZero(ty);
+  return m->get_constant_zero(ty);
 }
 /*!
  *@brief 打印常量零值
  *@return 字符串
  *constant int zero
  */
-std::string ConstantZero::print() { return "zeroinitializer"; }
+void ConstantZero::print(IROStream &os) { os << "zeroinitializer"; }
 
 ConstantFloat *ConstantFloat::get(float val, Module *m) {
-    return new ConstantFloat(Type::get_float_type(m), val);
+    return m->get_constant_float(val);
 }
 
-std::string ConstantFloat::print() {
+void ConstantFloat::print(IROStream &os) {
     // 将 float 转换为 LLVM IR 要求的 hex 格式字符串，或者简单的科学计数法
     char buffer[50];
-    sprintf(buffer, "%e", this->value_); 
-    return std::string(buffer);
+    int n = snprintf(buffer, sizeof(buffer), "%e", this->value_);
+    os.write(buffer, n);
 }
\ No newline at end of file
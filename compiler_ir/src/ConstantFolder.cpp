@@ -0,0 +1,154 @@
+/*!
+ *@file ConstantFolder.cpp
+ *@brief 常量折叠定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "ConstantFolder.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+
+/*!
+ *@brief 折叠二元算术运算
+ *@note
+ *----------
+ *&emsp; 整数加减乘在 uint32_t 上计算再转回 int，得到补码回绕结果
+ *&emsp; 除数为 0 及 INT_MIN / -1 在运行时才有定义的行为，不折叠
+ *&emsp; 浮点运算在 float 上计算，结果为 inf/nan 时不折叠
+ *&emsp; fadd 等当前以整数操作码创建，因此按操作数类型区分整数与浮点
+ */
+Constant *ConstantFolder::fold_binary(Instruction::OpID op, Value *lhs,
+                                      Value *rhs) {
+  auto li = dynamic_cast<ConstantInt *>(lhs);
+  auto ri = dynamic_cast<ConstantInt *>(rhs);
+  if (li && ri) {
+    int32_t a = li->get_value(), b = ri->get_value();
+    uint32_t ua = (uint32_t)a, ub = (uint32_t)b;
+    switch (op) {
+    case Instruction::add:
+      return ConstantInt::get((int)(ua + ub), m_);
+    case Instruction::sub:
+      return ConstantInt::get((int)(ua - ub), m_);
+    case Instruction::mul:
+      return ConstantInt::get((int)(ua * ub), m_);
+    case Instruction::sdiv:
+    case Instruction::mod:
+      if (b == 0 || (a == INT_MIN && b == -1)) {
+        return nullptr;
+      }
+      return ConstantInt::get(op == Instruction::sdiv ? a / b : a % b, m_);
+    default:
+      return nullptr;
+    }
+  }
+
+  auto lf = dynamic_cast<ConstantFloat *>(lhs);
+  auto rf = dynamic_cast<ConstantFloat *>(rhs);
+  if (lf && rf) {
+    float a = lf->get_value(), b = rf->get_value();
+    float res;
+    switch (op) {
+    case Instruction::add:
+    case Instruction::fadd:
+      res = a + b;
+      break;
+    case Instruction::sub:
+    case Instruction::fsub:
+      res = a - b;
+      break;
+    case Instruction::mul:
+    case Instruction::fmul:
+      res = a * b;
+      break;
+    case Instruction::sdiv:
+    case Instruction::fdiv:
+      res = a / b;
+      break;
+    default:
+      return nullptr;
+    }
+    if (!std::isfinite(res)) {
+      return nullptr;
+    }
+    return ConstantFloat::get(res, m_);
+  }
+  return nullptr;
+}
+
+/*!
+ *@brief 折叠比较运算
+ *@note
+ *----------
+ *&emsp; 整数（含 i1）按有符号值比较
+ *&emsp; 浮点按 C 语义比较：NaN 参与时只有 != 为真
+ */
+Constant *ConstantFolder::fold_cmp(CmpInst::CmpOp op, Value *lhs, Value *rhs) {
+  auto li = dynamic_cast<ConstantInt *>(lhs);
+  auto ri = dynamic_cast<ConstantInt *>(rhs);
+  auto lf = dynamic_cast<ConstantFloat *>(lhs);
+  auto rf = dynamic_cast<ConstantFloat *>(rhs);
+  bool res;
+  if (li && ri) {
+    int a = li->get_value(), b = ri->get_value();
+    switch (op) {
+    case CmpInst::EQ: res = a == b; break;
+    case CmpInst::NE: res = a != b; break;
+    case CmpInst::GT: res = a > b; break;
+    case CmpInst::GE: res = a >= b; break;
+    case CmpInst::LT: res = a < b; break;
+    case CmpInst::LE: res = a <= b; break;
+    default: return nullptr;
+    }
+  } else if (lf && rf) {
+    float a = lf->get_value(), b = rf->get_value();
+    switch (op) {
+    case CmpInst::EQ: res = a == b; break;
+    case CmpInst::NE: res = a != b; break;
+    case CmpInst::GT: res = a > b; break;
+    case CmpInst::GE: res = a >= b; break;
+    case CmpInst::LT: res = a < b; break;
+    case CmpInst::LE: res = a <= b; break;
+    default: return nullptr;
+    }
+  } else {
+    return nullptr;
+  }
+  return ConstantInt::get(res, m_);
+}
+
+/*!
+ *@brief 折叠类型转换
+ *@note
+ *----------
+ *&emsp; zext：i1 常量取 0/1 作为 i32
+ *&emsp; sitofp：按 float 舍入
+ *&emsp; fptosi：向零截断，NaN 或超出 [INT_MIN, INT_MAX] 时结果未定义，不折叠
+ */
+Constant *ConstantFolder::fold_cast(Instruction::OpID op, Value *val,
+                                    Type *ty) {
+  if (op == Instruction::zext) {
+    auto c = dynamic_cast<ConstantInt *>(val);
+    if (c && c->get_type()->is_int1_type() && ty->is_int32_type()) {
+      return ConstantInt::get(c->get_value(), m_);
+    }
+  } else if (op == Instruction::sitofp) {
+    auto c = dynamic_cast<ConstantInt *>(val);
+    if (c && ty->is_float_type()) {
+      return ConstantFloat::get((float)c->get_value(), m_);
+    }
+  } else if (op == Instruction::fptosi) {
+    auto c = dynamic_cast<ConstantFloat *>(val);
+    if (c && ty->is_int32_type()) {
+      float f = c->get_value();
+      // 2^31 可被 float 精确表示，右端取开区间
+      if (!(f >= -2147483648.0f && f < 2147483648.0f)) {
+        return nullptr;
+      }
+      return ConstantInt::get((int)f, m_);
+    }
+  }
+  return nullptr;
+}
@@ -0,0 +1,378 @@
+/*!
+ *@file DominatorTree.cpp
+ *@brief 支配树与支配边界分析定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "DominatorTree.h"
+#include "IRprinter.h"
+
+#include <utility>
+
+namespace {
+
+constexpr unsigned kNone = Value::kNoNumber;
+
+} // namespace
+
+/*!
+ *@brief 构造并计算支配树
+ *@param func 有函数体的函数
+ *@param post 为 true 时计算后支配树
+ */
+DominatorTree::DominatorTree(Function *func, bool post)
+    : func_(func), post_(post) {
+  recalculate();
+}
+
+/*!
+ *@brief 按函数当前的 CFG 重新计算
+ *@note
+ *----------
+ *&emsp; 记下 CFG 版本，之后版本改变即视为过期
+ *&emsp; 各数组按块编号上界重新开辟，沿用已有的容量
+ */
+void DominatorTree::recalculate() {
+  assert(!func_->is_declaration() && "dominator tree of a declaration");
+  version_ = func_->get_cfg_version();
+  frontier_built_ = false;
+  build_edges();
+  compute_post_order();
+  compute_idoms();
+}
+
+/*!
+ *@brief 按分析方向建立压缩邻接表
+ *@note
+ *----------
+ *&emsp; 支配树的后继即 CFG 后继；后支配树的后继为 CFG 前驱，
+ *&emsp; 虚拟出口的后继为全部没有后继的块
+ *&emsp; 结点 i 的后继为 succ_[succ_begin_[i]] 到 succ_[succ_begin_[i + 1]]，
+ *&emsp; 前驱表由后继表转置得到，两者的边一一对应
+ *&emsp; 重复边（条件跳转两个目标相同）保留，不影响结果
+ */
+void DominatorTree::build_edges() {
+  unsigned num_blocks = func_->get_block_number_bound();
+  unsigned total = post_ ? num_blocks + 1 : num_blocks;
+  blocks_.assign(total, nullptr);
+  for (auto bb : func_->get_basic_blocks()) {
+    blocks_[bb->get_number()] = bb;
+  }
+
+  succ_begin_.assign(total + 1, 0);
+  succ_.clear();
+  std::vector<unsigned> exits;
+  for (unsigned i = 0; i < num_blocks; i++) {
+    succ_begin_[i] = succ_.size();
+    BasicBlock *bb = blocks_[i];
+    if (bb == nullptr) {
+      continue;
+    }
+    if (post_) {
+      for (auto pred : bb->get_pre_basic_blocks()) {
+        succ_.push_back(pred->get_number());
+      }
+      if (bb->get_succ_basic_blocks().empty()) {
+        exits.push_back(i);
+      }
+    } else {
+      for (auto succ : bb->get_succ_basic_blocks()) {
+        succ_.push_back(succ->get_number());
+      }
+    }
+  }
+  if (post_) {
+    succ_begin_[num_blocks] = succ_.size();
+    succ_.insert(succ_.end(), exits.begin(), exits.end());
+  }
+  succ_begin_[total] = succ_.size();
+  root_ = post_ ? num_blocks : func_->get_entry_block()->get_number();
+
+  pred_begin_.assign(total + 1, 0);
+  for (auto s : succ_) {
+    pred_begin_[s + 1]++;
+  }
+  for (unsigned i = 0; i < total; i++) {
+    pred_begin_[i + 1] += pred_begin_[i];
+  }
+  pred_.resize(succ_.size());
+  std::vector<unsigned> fill(pred_begin_.begin(), pred_begin_.end() - 1);
+  for (unsigned i = 0; i < total; i++) {
+    for (unsigned e = succ_begin_[i]; e < succ_begin_[i + 1]; e++) {
+      pred_[fill[succ_[e]]++] = i;
+    }
+  }
+}
+
+/*!
+ *@brief 求后序号与逆后序
+ *@note
+ *----------
+ *&emsp; 以显式栈深度优先遍历，栈中记录结点与下一条待走的边，
+ *&emsp; 深层嵌套的循环不会耗尽调用栈
+ *&emsp; 未访问到的结点后序号为 kNoNumber，即不可达
+ *&emsp; 逆后序中不含虚拟出口
+ */
+void DominatorTree::compute_post_order() {
+  unsigned total = blocks_.size();
+  po_number_.assign(total, kNone);
+  rpo_.clear();
+  std::vector<char> visited(total, 0);
+  std::vector<std::pair<unsigned, unsigned>> stack;
+  std::vector<unsigned> post_order;
+  visited[root_] = 1;
+  stack.emplace_back(root_, succ_begin_[root_]);
+  while (!stack.empty()) {
+    unsigned n = stack.back().first;
+    unsigned &e = stack.back().second;
+    if (e < succ_begin_[n + 1]) {
+      unsigned s = succ_[e++];
+      if (!visited[s]) {
+        visited[s] = 1;
+        stack.emplace_back(s, succ_begin_[s]);
+      }
+      continue;
+    }
+    po_number_[n] = post_order.size();
+    post_order.push_back(n);
+    stack.pop_back();
+  }
+  for (auto it = post_order.rbegin(); it != post_order.rend(); ++it) {
+    if (blocks_[*it]) {
+      rpo_.push_back(blocks_[*it]);
+    }
+  }
+}
+
+/*!
+ *@brief 沿直接支配者上行求最近公共祖先
+ *@note
+ *----------
+ *&emsp; 祖先的后序号总大于子孙，每次让后序号小的一方上行
+ */
+unsigned DominatorTree::intersect(unsigned a, unsigned b) const {
+  while (a != b) {
+    while (po_number_[a] < po_number_[b]) {
+      a = idom_[a];
+    }
+    while (po_number_[b] < po_number_[a]) {
+      b = idom_[b];
+    }
+  }
+  return a;
+}
+
+/*!
+ *@brief 迭代求直接支配者并建树
+ *@note
+ *----------
+ *&emsp; 根的直接支配者记为自身，其余先记为未定
+ *&emsp; 按逆后序处理，新的直接支配者为已处理前驱的交，直到没有变化；
+ *&emsp; 可归约的 CFG 通常两轮即可
+ *&emsp; 之后按逆后序登记子结点，再深度优先给树编号：进入时取进序号，
+ *&emsp; 离开时取出序号，子树的区间嵌套在祖先的区间内
+ */
+void DominatorTree::compute_idoms() {
+  unsigned total = blocks_.size();
+  idom_.assign(total, kNone);
+  idom_[root_] = root_;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto bb : rpo_) {
+      unsigned b = bb->get_number();
+      if (b == root_) {
+        continue;
+      }
+      unsigned new_idom = kNone;
+      for (unsigned e = pred_begin_[b]; e < pred_begin_[b + 1]; e++) {
+        unsigned p = pred_[e];
+        if (idom_[p] == kNone) {
+          continue;
+        }
+        new_idom = new_idom == kNone ? p : intersect(p, new_idom);
+      }
+      if (idom_[b] != new_idom) {
+        idom_[b] = new_idom;
+        changed = true;
+      }
+    }
+  }
+
+  children_.resize(total);
+  for (auto &c : children_) {
+    c.clear();
+  }
+  for (auto bb : rpo_) {
+    unsigned b = bb->get_number();
+    if (b != root_) {
+      children_[idom_[b]].push_back(bb);
+    }
+  }
+  if (post_) {
+    roots_ = children_[root_];
+  } else {
+    roots_.assign(1, blocks_[root_]);
+  }
+
+  dfs_in_.assign(total, 0);
+  dfs_out_.assign(total, 0);
+  unsigned counter = 0;
+  std::vector<std::pair<unsigned, unsigned>> stack;
+  dfs_in_[root_] = counter++;
+  stack.emplace_back(root_, 0);
+  while (!stack.empty()) {
+    unsigned n = stack.back().first;
+    unsigned &i = stack.back().second;
+    if (i < children_[n].size()) {
+      unsigned c = children_[n][i++]->get_number();
+      dfs_in_[c] = counter++;
+      stack.emplace_back(c, 0);
+      continue;
+    }
+    dfs_out_[n] = counter++;
+    stack.pop_back();
+  }
+}
+
+/*!
+ *@brief 求直接支配者
+ *@param bb 本函数中的基本块
+ *@return 直接支配者；根与不可达的块为空，虚拟出口对应的下标本就为空
+ */
+BasicBlock *DominatorTree::get_idom(BasicBlock *bb) const {
+  unsigned b = node(bb);
+  if (b == root_ || idom_[b] == kNone) {
+    return nullptr;
+  }
+  return blocks_[idom_[b]];
+}
+
+/*!
+ *@brief a 是否支配 b
+ *@note
+ *----------
+ *&emsp; 比较树上的进出序号，O(1)
+ */
+bool DominatorTree::dominates(BasicBlock *a, BasicBlock *b) const {
+  if (a == b) {
+    return true;
+  }
+  unsigned ia = node(a);
+  unsigned ib = node(b);
+  if (idom_[ib] == kNone) {
+    return true;
+  }
+  if (idom_[ia] == kNone) {
+    return false;
+  }
+  return dfs_in_[ia] <= dfs_in_[ib] && dfs_out_[ib] <= dfs_out_[ia];
+}
+
+/*!
+ *@brief 最近公共支配者
+ *@note
+ *----------
+ *&emsp; 一方支配另一方时直接返回，否则沿树上行求交
+ */
+BasicBlock *DominatorTree::find_nearest_common_dominator(BasicBlock *a,
+                                                         BasicBlock *b) const {
+  unsigned ia = node(a);
+  unsigned ib = node(b);
+  if (idom_[ia] == kNone || idom_[ib] == kNone) {
+    return nullptr;
+  }
+  if (dominates(a, b)) {
+    return a;
+  }
+  if (dominates(b, a)) {
+    return b;
+  }
+  return blocks_[intersect(ia, ib)];
+}
+
+/*!
+ *@brief 求全部块的支配边界
+ *@note
+ *----------
+ *&emsp; 对每个块 b 的每个可达前驱 p，从 p 沿直接支配者上行到 b 的直接
+ *&emsp; 支配者为止，途经的块的边界都含 b
+ *&emsp; 根没有直接支配者，从 p 一直走到根（含根），循环回到根的边使根
+ *&emsp; 属于其自身及途经块的边界
+ *&emsp; 同一个 b 的加入都发生在处理 b 时，只需与表尾比较即可去重
+ */
+void DominatorTree::compute_frontiers() {
+  frontier_.resize(blocks_.size());
+  for (auto &df : frontier_) {
+    df.clear();
+  }
+  for (auto bb : rpo_) {
+    unsigned b = bb->get_number();
+    unsigned stop = b == root_ ? kNone : idom_[b];
+    for (unsigned e = pred_begin_[b]; e < pred_begin_[b + 1]; e++) {
+      unsigned runner = pred_[e];
+      if (idom_[runner] == kNone) {
+        continue;
+      }
+      while (runner != stop) {
+        auto &df = frontier_[runner];
+        if (df.empty() || df.back() != bb) {
+          df.push_back(bb);
+        }
+        runner = runner == root_ ? kNone : idom_[runner];
+      }
+    }
+  }
+  frontier_built_ = true;
+}
+
+/*!
+ *@brief 块的支配边界
+ *@param bb 本函数中的基本块
+ *@return 边界中的块，按各块在逆后序中首次加入的次序排列
+ */
+const std::vector<BasicBlock *> &
+DominatorTree::get_dominance_frontier(BasicBlock *bb) {
+  unsigned b = node(bb);
+  if (!frontier_built_) {
+    compute_frontiers();
+  }
+  return frontier_[b];
+}
+
+/*!
+ *@brief 打印各块的直接支配者与支配边界
+ *@param os 输出流
+ *@note
+ *----------
+ *&emsp; 按布局顺序每块一行，以注释形式输出，不影响中间代码的读入
+ *&emsp; 没有直接支配者的块打印 -，不可达的块打印 unreachable
+ */
+void DominatorTree::print(IROStream &os) {
+  os << "; " << (post_ ? "post-dominator" : "dominator") << " tree for @"
+     << func_->get_name() << '\n';
+  for (auto bb : func_->get_basic_blocks()) {
+    os << ";   %";
+    print_name(os, bb);
+    if (!is_reachable(bb)) {
+      os << ": unreachable\n";
+      continue;
+    }
+    os << ": idom = ";
+    if (auto idom = get_idom(bb)) {
+      os << '%';
+      print_name(os, idom);
+    } else {
+      os << '-';
+    }
+    os << ", frontier = {";
+    const char *sep = " ";
+    for (auto df : get_dominance_frontier(bb)) {
+      os << sep << '%';
+      print_name(os, df);
+      sep = ", ";
+    }
+    os << " }\n";
+  }
+}
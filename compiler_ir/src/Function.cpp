@@ -6,9 +6,15 @@
  */
 
 #include "Function.h"
+#include "DominatorTree.h"
 #include "IRprinter.h"
 #include "Module.h"
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <unordered_map>
+
 /**
  * @brief Construct a new Function object
  *
@@ -19,11 +25,23 @@
  * @note 函数创建参数列表
  */
 Function::Function(FunctionType *ty, const std::string &name, Module *parent)
-    : Value(ty, name), parent_(parent), seq_cnt_(0) {
+    : Value(ty, name), parent_(parent) {
+  set_shared();
   parent->add_function(this);
   build_args();
 }
 
+/**
+ * @brief Destroy the Function object
+ *
+ * @note 参数、基本块与指令都在模块的内存池中，由模块统一释放
+ * @note 缓存的支配树在堆上，随函数释放
+ */
+Function::~Function() {
+  delete dom_tree_;
+  delete post_dom_tree_;
+}
+
 /**
  * @brief 创建函数对象
  *
@@ -34,7 +52,7 @@ Function::Function(FunctionType *ty, const std::string &name, Module *parent)
  */
 Function *Function::create(FunctionType *ty, const std::string &name,
                            Module *parent) {
-  return new Function(ty, name, parent);
+  return new (parent) Function(ty, name, parent);
 }
 
 /**
@@ -83,13 +101,20 @@ Module *Function::get_parent() const { return parent_; }
  *
  * @param bb 基本块指针
  * @note 删除phi节点对于基本块的使用
- * @note 删除前置基本块中对于该基本块的后继
  * @note 删除后继基本块中对于该基本块的前继
+ * @note 前驱块的跳转仍指向该块，须由调用者先行改写
+ * @note 收回该基本块及其指令的编号
  */
 void Function::remove(BasicBlock *bb) {
   basic_blocks_.remove(bb);
+  invalidate_cfg();
+  bb->set_number(kNoNumber);
+  holes_++;
+  for (auto instr : bb->get_instructions()) {
+    release_number(instr);
+  }
   std::vector<PhiInst *> phis;
-  for (auto user : bb->get_use_list()) {
+  for (auto &user : bb->get_use_list()) {
     auto phi = dynamic_cast<PhiInst *>(user.val_);
     if (phi != nullptr) {
       phis.push_back(phi);
@@ -99,14 +124,77 @@ void Function::remove(BasicBlock *bb) {
   for (auto phi : phis) {
     phi->remove_source(bb);
   }
-  /// 删除前置基本块中对于该基本块的后继
-  for (auto pre : bb->get_pre_basic_blocks()) {
-    pre->remove_succ_basic_block(bb);
+  /// 撤销终结跳转的出边，删除后继基本块中对于该基本块的前继
+  Instruction *term = bb->get_terminator();
+  if (term && term->is_br()) {
+    static_cast<BranchInst *>(term)->unlink_edges();
   }
-  /// 删除后继基本块中对于该基本块的前继
-  for (auto succ : bb->get_succ_basic_blocks()) {
-    succ->remove_pre_basic_block(bb);
+}
+
+/**
+ * @brief 拆分关键边，在 from 与它的第 succ_num 个后继之间插入一个新基本块
+ *
+ * @param from 边的起点，须以跳转指令结束
+ * @param succ_num 边在 from 的跳转中的后继序号
+ * @return BasicBlock* 新基本块
+ * @note 新块追加到函数末尾后移到 from 之后，编号照常分配
+ * @note 新块的跳转建立 新块->to 的入边，set_successor 只把这一条 from->to
+ *       改为 from->新块；两个目标相同的条件跳转，另一条边保持不变
+ * @note to 中每个 phi 也只改写一个来自 from 的入口，与被拆的边对应
+ */
+BasicBlock *Function::split_edge(BasicBlock *from, unsigned succ_num) {
+  auto br = dynamic_cast<BranchInst *>(from->get_terminator());
+  assert(br && "edge source does not end with a branch");
+  BasicBlock *to = br->get_successor(succ_num);
+  auto mid = BasicBlock::create(parent_, "", this);
+  basic_blocks_.pop_back();
+  auto pos = std::find(basic_blocks_.begin(), basic_blocks_.end(), from);
+  assert(pos != basic_blocks_.end() && "edge source not in this function");
+  basic_blocks_.insert(std::next(pos), mid);
+
+  BranchInst::create_br(to, mid);
+  br->set_successor(succ_num, mid);
+  for (auto instr : to->get_instructions()) {
+    if (!instr->is_phi()) {
+      break;
+    }
+    for (unsigned i = 1; i < instr->get_num_operand(); i += 2) {
+      if (instr->get_operand(i) == from) {
+        instr->set_operand(i, mid);
+        break;
+      }
+    }
   }
+  return mid;
+}
+
+/**
+ * @brief 释放全部基本块与指令，函数变回声明
+ *
+ * @note 先摘除全部指令的 use，函数体内的 value 就不再被引用，
+ *       之后按任意顺序释放指令与基本块
+ * @note 编号从0重新开始，缓存的支配树作废
+ */
+void Function::delete_body() {
+  for (auto bb : basic_blocks_) {
+    for (auto instr : bb->get_instructions()) {
+      instr->remove_use_of_ops();
+    }
+  }
+  for (auto bb : basic_blocks_) {
+    auto &instrs = bb->get_instructions();
+    while (!instrs.empty()) {
+      Instruction *instr = instrs.front();
+      instrs.remove(instr);
+      delete instr;
+    }
+    delete bb;
+  }
+  basic_blocks_.clear();
+  invalidate_cfg();
+  block_bound_ = 0;
+  instr_bound_ = 0;
+  holes_ = 0;
 }
 
 /**
@@ -120,7 +208,8 @@ void Function::build_args() {
   auto *func_ty = get_function_type();
   unsigned num_args = get_num_of_args();
   for (int i = 0; i < (int)num_args; i++) {
-    arguments_.push_back(new Argument(func_ty->get_param_type(i), "", this, i));
+    arguments_.push_back(
+        new (parent_) Argument(func_ty->get_param_type(i), "", this, i));
   }
 }
 
@@ -129,112 +218,162 @@ void Function::build_args() {
  *
  * @param bb 基本块指针
  */
-void Function::add_basic_block(BasicBlock *bb) { basic_blocks_.push_back(bb); }
+void Function::add_basic_block(BasicBlock *bb) {
+  basic_blocks_.push_back(bb);
+  assign_number(bb);
+  invalidate_cfg();
+}
 
 /**
- * @brief Set the instr name object，为参数和基本块设置名称
+ * @brief 为尚未编号的基本块及其中尚未编号的指令分配编号
  *
- * @note 针对函数的参数设置名称
- * @note 针对函数内部的基本块设置名称，并针对每个基本块的指令设置名称
+ * @param bb 基本块指针
+ * @note 游离块在 insert_into 时才进入函数，其中已有的指令在此一并编号
  */
-void Function::set_instr_name() {
-  /// 针对函数的参数设置名称，
-  std::map<Value *, int> seq;
-  for (auto arg : this->get_args()) {
-    if (seq.find(arg) == seq.end()) {
-      auto seq_num = seq.size() + seq_cnt_;
-      if (arg->set_name("arg" + std::to_string(seq_num))) {
-        seq.insert({arg, seq_num});
-      }
+void Function::assign_number(BasicBlock *bb) {
+  if (bb->get_number() == kNoNumber) {
+    bb->set_number(block_bound_++);
+  }
+  for (auto instr : bb->get_instructions()) {
+    assign_number(instr);
+  }
+}
+
+/**
+ * @brief 按布局顺序重新分配连续编号
+ *
+ * @note 块与指令分别从0开始计数，完成后没有空洞
+ * @note 支配树以块编号为下标，重新编号后作废
+ */
+void Function::renumber() {
+  invalidate_cfg();
+  block_bound_ = 0;
+  instr_bound_ = 0;
+  holes_ = 0;
+  for (auto bb : basic_blocks_) {
+    bb->set_number(block_bound_++);
+    for (auto instr : bb->get_instructions()) {
+      instr->set_number(instr_bound_++);
+    }
+  }
+}
+
+/**
+ * @brief 获取支配树
+ *
+ * @return DominatorTree* 支配树
+ * @note 首次获取时计算；此后 CFG 版本未变则直接返回，变了则就地重新计算
+ */
+DominatorTree *Function::get_dominator_tree() {
+  if (dom_tree_ == nullptr) {
+    dom_tree_ = new DominatorTree(this);
+  } else if (!dom_tree_->is_up_to_date()) {
+    dom_tree_->recalculate();
+  }
+  return dom_tree_;
+}
+
+/**
+ * @brief 获取后支配树
+ *
+ * @return DominatorTree* 后支配树
+ * @note 缓存方式与 get_dominator_tree 相同
+ */
+DominatorTree *Function::get_post_dominator_tree() {
+  if (post_dom_tree_ == nullptr) {
+    post_dom_tree_ = new DominatorTree(this, true);
+  } else if (!post_dom_tree_->is_up_to_date()) {
+    post_dom_tree_->recalculate();
+  }
+  return post_dom_tree_;
+}
+
+/**
+ * @brief 为未命名的参数、基本块和指令编号
+ *
+ * @note 参数、基本块、有结果的指令按出现顺序共用一个从0开始的计数，
+ *       编号存于value自身，不生成名称字符串；每次打印前重新编号
+ * @note 生成器会给多个基本块取相同的名字（如每个 if 的 if_true），
+ *       有名称的基本块的编号记为该名字此前出现的次数，打印时大于0的
+ *       加上 .编号 后缀，使标号在函数内唯一；名称已驻留，按地址计数
+ */
+void Function::number_slots() {
+  unsigned slot = 0;
+  for (auto arg : arguments_) {
+    if (!arg->has_name()) {
+      arg->set_slot(slot++);
     }
   }
-  /// 针对函数内部的基本块设置名称，并针对每个基本块的指令设置名称
+  std::unordered_map<const std::string *, unsigned> label_uses;
   for (auto bb : basic_blocks_) {
-    if (seq.find(bb) == seq.end()) {
-      auto seq_num = seq.size() + seq_cnt_;
-      if (bb->set_name("label" + std::to_string(seq_num))) {
-        seq.insert({bb, seq_num});
-      }
+    if (!bb->has_name()) {
+      bb->set_slot(slot++);
+    } else {
+      bb->set_slot(label_uses[&bb->get_name()]++);
     }
     for (auto instr : bb->get_instructions()) {
-      if (!instr->is_void() && seq.find(instr) == seq.end()) {
-        auto seq_num = seq.size() + seq_cnt_;
-        if (instr->set_name("op" + std::to_string(seq_num))) {
-          seq.insert({instr, seq_num});
-        }
+      if (!instr->is_void() && !instr->has_name()) {
+        instr->set_slot(slot++);
       }
     }
   }
-  seq_cnt_ += seq.size();
 }
 
 /**
  * @brief 打印函数
  *
- * @return std::string 字符串
+ * @param os 输出流
+ * @note 先为未命名的value编号
  * @note 判断函数是声明还是定义
  * @note 依次添加函数类型和名称
  * @note 函数为声明/定义，不同添加规则
  * @note 函数为声明，换行结束/为定义，依次打印基本块
  */
-std::string Function::print() {
-  set_instr_name();
-  std::string func_ir;
-  if (this->is_declaration()) {
-    func_ir += "declare ";
-  } else {
-    func_ir += "define ";
-  }
-
-  func_ir += this->get_return_type()->print();
-  func_ir += " ";
-  func_ir += print_as_op(this, false);
-  func_ir += "(";
+void Function::print(IROStream &os) {
+  number_slots();
+  os << (this->is_declaration() ? "declare " : "define ");
+  os << this->get_return_type()->print() << ' ';
+  print_as_op(os, this, false);
+  os << '(';
 
   // print arg
   if (this->is_declaration()) {
     for (int i = 0; i < static_cast<int>(this->get_num_of_args()); i++) {
       if (i)
-        func_ir += ", ";
-      func_ir += static_cast<FunctionType *>(this->get_type())
-                     ->get_param_type(i)
-                     ->print();
+        os << ", ";
+      os << static_cast<FunctionType *>(this->get_type())
+                ->get_param_type(i)
+                ->print();
     }
   } else {
     for (auto arg = this->arg_begin(); arg != arg_end(); arg++) {
       if (arg != this->arg_begin()) {
-        func_ir += ", ";
+        os << ", ";
       }
-      func_ir += static_cast<Argument *>(*arg)->print();
+      static_cast<Argument *>(*arg)->print(os);
     }
   }
-  func_ir += ")";
+  os << ')';
 
   // print bb
   if (this->is_declaration()) {
-    func_ir += "\n";
+    os << '\n';
   } else {
-    func_ir += " {";
-    func_ir += "\n";
+    os << " {\n";
     for (auto bb : this->get_basic_blocks()) {
-      func_ir += bb->print();
+      bb->print(os);
     }
-    func_ir += "}";
+    os << '}';
   }
-
-  return func_ir;
 }
 
 /**
  * @brief 打印参数列表
  *
- * @return std::string 字符串
+ * @param os 输出流
  * @note 依次打印参数的类型和名称
  */
-std::string Argument::print() {
-  std::string arg_ir;
-  arg_ir += this->get_type()->print();
-  arg_ir += " %";
-  arg_ir += this->get_name();
-  return arg_ir;
+void Argument::print(IROStream &os) {
+  os << this->get_type()->print() << " %";
+  print_name(os, this);
 }
\ No newline at end of file
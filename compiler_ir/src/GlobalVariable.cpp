@@ -23,6 +23,7 @@
 GlobalVariable::GlobalVariable(std::string name, Module *m, Type *ty,
                                bool is_const, Constant *init)
     : User(ty, name, init != nullptr), is_const_(is_const), init_val_(init) {
+  set_shared();
   m->add_global_variable(this);
   if (init) {
     this->set_operand(0, init);
@@ -45,27 +46,22 @@ GlobalVariable::GlobalVariable(std::string name, Module *m, Type *ty,
 GlobalVariable *GlobalVariable::create(std::string name, Module *m, Type *ty,
                                        bool is_const,
                                        Constant *init = nullptr) {
-  return new GlobalVariable(name, m, PointerType::get(ty), is_const, init);
+  return new (m) GlobalVariable(name, m, PointerType::get(ty), is_const, init);
 }
 
 /*!
  *@brief 打印全局变量
- *@return 字符串
+ *@param os 输出流
  *@note
  *--------
- *初始化字符串
  *添加名称
  *添加常量类型
  *添加数据指针所指向数据的类型
  *添加变量初值
  */
-std::string GlobalVariable::print() {
-  std::string global_val_ir;
-  global_val_ir += print_as_op(this, false);
-  global_val_ir += " = ";
-  global_val_ir += (this->is_const() ? "constant " : "global ");
-  global_val_ir += this->get_type()->get_pointer_element_type()->print();
-  global_val_ir += " ";
-  global_val_ir += this->get_init()->print();
-  return global_val_ir;
+void GlobalVariable::print(IROStream &os) {
+  print_as_op(os, this, false);
+  os << " = " << (this->is_const() ? "constant " : "global ");
+  os << this->get_type()->get_pointer_element_type()->print() << ' ';
+  this->get_init()->print(os);
 }
\ No newline at end of file
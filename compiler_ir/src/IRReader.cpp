@@ -0,0 +1,951 @@
+/*!
+ *@file IRReader.cpp
+ *@brief 文本中间代码读取定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "IRReader.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "Function.h"
+#include "GlobalVariable.h"
+#include "Instruction.h"
+#include "Module.h"
+#include "Type.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+/// 名称与关键字中允许的字符
+bool is_ident(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '$' ||
+         c == '-';
+}
+
+/// name 是否为 prefix 后接数字，即打印时编号的未命名value
+bool is_numbered(std::string_view name, std::string_view prefix) {
+  if (name.size() <= prefix.size() || name.substr(0, prefix.size()) != prefix) {
+    return false;
+  }
+  for (char c : name.substr(prefix.size())) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// 整数比较谓词，浮点比较在前缀 o 之后与之相同
+bool cmp_op(std::string_view pred, CmpInst::CmpOp &op) {
+  static const std::pair<std::string_view, CmpInst::CmpOp> table[] = {
+      {"eq", CmpInst::EQ},  {"ne", CmpInst::NE},  {"sgt", CmpInst::GT},
+      {"sge", CmpInst::GE}, {"slt", CmpInst::LT}, {"sle", CmpInst::LE},
+      {"oeq", CmpInst::EQ}, {"one", CmpInst::NE}, {"ogt", CmpInst::GT},
+      {"oge", CmpInst::GE}, {"olt", CmpInst::LT}, {"ole", CmpInst::LE},
+  };
+  for (auto &entry : table) {
+    if (entry.first == pred) {
+      op = entry.second;
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+bool IRReader::fail(const std::string &msg) {
+  error_ = cur_ ? "line " + std::to_string(line_) + ": " + msg : msg;
+  return false;
+}
+
+/*!
+ *@brief 读入文件
+ *@note 文本按记号逐字符扫描，整体读入并在末尾补零，省去越界检查
+ */
+bool IRReader::open(const std::string &path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return fail("cannot open " + path);
+  }
+  // 按文件大小一次读入，避免逐字符的流迭代
+  std::streamoff size = in.tellg();
+  in.seekg(0);
+  text_.resize(size > 0 ? static_cast<size_t>(size) : 0);
+  if (size > 0 && !in.read(&text_[0], size)) {
+    return fail("cannot read " + path);
+  }
+  return true;
+}
+
+void IRReader::set_buffer(const char *data, size_t size) {
+  text_.assign(data, size);
+}
+
+void IRReader::skip_space() {
+  for (;;) {
+    char c = *cur_;
+    if (c == '\n') {
+      line_++;
+      cur_++;
+    } else if (c == ' ' || c == '\t' || c == '\r') {
+      cur_++;
+    } else if (c == ';') {
+      while (*cur_ && *cur_ != '\n') {
+        cur_++;
+      }
+    } else {
+      return;
+    }
+  }
+}
+
+void IRReader::skip_blank() {
+  while (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\r') {
+    cur_++;
+  }
+}
+
+/*!
+ *@brief 越过本行余下的空白与注释
+ *@return 注释为 "; preds = ..." 时返回等号之后的内容，否则为空
+ *@note cur_ 停在换行符或文本末尾
+ */
+std::string_view IRReader::rest_of_line() {
+  skip_blank();
+  if (*cur_ != ';') {
+    return {};
+  }
+  const char *begin = ++cur_;
+  while (*cur_ && *cur_ != '\n') {
+    cur_++;
+  }
+  std::string_view note(begin, cur_ - begin);
+  size_t pos = note.find_first_not_of(' ');
+  if (pos == std::string_view::npos ||
+      note.substr(pos, 7) != std::string_view("preds =")) {
+    return {};
+  }
+  return note.substr(pos + 7);
+}
+
+bool IRReader::at_line_end() {
+  rest_of_line();
+  return *cur_ == '\n' || *cur_ == '\0';
+}
+
+bool IRReader::consume(char c) {
+  skip_blank();
+  if (*cur_ != c) {
+    return false;
+  }
+  cur_++;
+  return true;
+}
+
+bool IRReader::expect(char c) {
+  return consume(c) || fail(std::string("expected '") + c + "'");
+}
+
+std::string_view IRReader::word() {
+  skip_blank();
+  const char *begin = cur_;
+  while (is_ident(*cur_)) {
+    cur_++;
+  }
+  return std::string_view(begin, cur_ - begin);
+}
+
+bool IRReader::consume_word(std::string_view w) {
+  skip_blank();
+  if (std::strncmp(cur_, w.data(), w.size()) != 0 || is_ident(cur_[w.size()])) {
+    return false;
+  }
+  cur_ += w.size();
+  return true;
+}
+
+bool IRReader::expect_word(std::string_view w) {
+  return consume_word(w) || fail("expected '" + std::string(w) + "'");
+}
+
+bool IRReader::name(char sigil, std::string_view &out) {
+  if (!consume(sigil)) {
+    return fail(std::string("expected '") + sigil + "' name");
+  }
+  const char *begin = cur_;
+  while (is_ident(*cur_)) {
+    cur_++;
+  }
+  if (cur_ == begin) {
+    return fail("empty name");
+  }
+  out = std::string_view(begin, cur_ - begin);
+  return true;
+}
+
+bool IRReader::integer(long long &out) {
+  skip_blank();
+  char *end;
+  out = std::strtoll(cur_, &end, 10);
+  if (end == cur_) {
+    return fail("expected integer");
+  }
+  cur_ = end;
+  return true;
+}
+
+bool IRReader::at_type() {
+  skip_blank();
+  if (*cur_ == '[') {
+    return true;
+  }
+  const char *end = cur_;
+  while (is_ident(*end)) {
+    end++;
+  }
+  std::string_view w(cur_, end - cur_);
+  return w == "i32" || w == "i1" || w == "float" || w == "void" ||
+         w == "label";
+}
+
+/*!
+ *@brief 读取类型
+ *@note
+ *----------
+ *&emsp; 基础类型 void、label、i1、i32、float，或数组 [N x T]
+ *&emsp; 其后每个 * 再取一层指针
+ */
+bool IRReader::parse_type(Type *&ty) {
+  Module *m = module_;
+  skip_blank();
+  if (consume('[')) {
+    long long n;
+    Type *elem;
+    if (!integer(n) || !expect_word("x") || !parse_type(elem) ||
+        !expect(']')) {
+      return false;
+    }
+    ty = m->get_array_type(elem, static_cast<unsigned>(n));
+  } else {
+    std::string_view w = word();
+    if (w == "i32") {
+      ty = m->get_int32_type();
+    } else if (w == "i1") {
+      ty = m->get_int1_type();
+    } else if (w == "float") {
+      ty = m->get_float_type();
+    } else if (w == "void") {
+      ty = m->get_void_type();
+    } else if (w == "label") {
+      ty = m->get_label_type();
+    } else {
+      return fail("unknown type '" + std::string(w) + "'");
+    }
+  }
+  while (consume('*')) {
+    ty = m->get_pointer_type(ty);
+  }
+  return true;
+}
+
+/*!
+ *@brief 读取给定类型的常量
+ *@note
+ *----------
+ *&emsp; 整数与 i1 的 true/false；float 接受十进制（含 inf、nan）与
+ *&emsp; LLVM 的 0x 加 16 位十六进制（double 的位模式）
+ *&emsp; zeroinitializer 与数组常量 [T c, T c, ...]
+ */
+bool IRReader::parse_constant(Type *ty, Constant *&c) {
+  Module *m = module_;
+  skip_blank();
+  if (consume_word("zeroinitializer")) {
+    c = ConstantZero::get(ty, m);
+    return true;
+  }
+  if (ty->is_array_type()) {
+    auto arr_ty = static_cast<ArrayType *>(ty);
+    std::vector<Constant *> elems;
+    if (!expect('[')) {
+      return false;
+    }
+    while (elems.size() < arr_ty->get_num_of_elements()) {
+      Type *elem_ty;
+      Constant *elem;
+      if ((!elems.empty() && !expect(',')) || !parse_type(elem_ty) ||
+          !parse_constant(elem_ty, elem)) {
+        return false;
+      }
+      if (elem_ty != arr_ty->get_element_type()) {
+        return fail("array element type mismatch");
+      }
+      elems.push_back(elem);
+    }
+    if (!expect(']')) {
+      return false;
+    }
+    c = ConstantArray::get(arr_ty, elems);
+    return true;
+  }
+  if (ty->is_float_type()) {
+    float val;
+    if (cur_[0] == '0' && (cur_[1] == 'x' || cur_[1] == 'X')) {
+      char *end;
+      uint64_t bits = std::strtoull(cur_ + 2, &end, 16);
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      val = static_cast<float>(d);
+      cur_ = end;
+    } else {
+      char *end;
+      val = std::strtof(cur_, &end);
+      if (end == cur_) {
+        return fail("expected float constant");
+      }
+      cur_ = end;
+    }
+    c = ConstantFloat::get(val, m);
+    return true;
+  }
+  if (ty->is_integer_type()) {
+    auto int_ty = static_cast<IntegerType *>(ty);
+    long long val;
+    if (consume_word("true")) {
+      val = 1;
+    } else if (consume_word("false")) {
+      val = 0;
+    } else if (!integer(val)) {
+      return false;
+    }
+    c = m->get_constant_int(int_ty, static_cast<int>(val));
+    return true;
+  }
+  return fail("bad constant of type " + ty->print());
+}
+
+/*!
+ *@brief 读取全局变量 @name = global|constant T init
+ */
+bool IRReader::parse_global() {
+  std::string_view gname;
+  Type *ty;
+  Constant *init;
+  if (!name('@', gname) || !expect('=')) {
+    return false;
+  }
+  bool is_const = consume_word("constant");
+  if (!is_const && !expect_word("global")) {
+    return false;
+  }
+  if (!parse_type(ty) || !parse_constant(ty, init)) {
+    return false;
+  }
+  if (globals_.count(gname)) {
+    return fail("redefinition of @" + std::string(gname));
+  }
+  globals_[gname] =
+      GlobalVariable::create(std::string(gname), module_, ty, is_const, init);
+  return at_line_end() || fail("expected end of line");
+}
+
+/*!
+ *@brief 读取局部value
+ *@param ty 由上下文确定的类型
+ *@note
+ *----------
+ *&emsp; %name：已定义的直接使用，否则建立同类型的占位value，定义时替换
+ *&emsp; @name：全局变量或函数
+ *&emsp; 其余按 ty 读取常量
+ */
+bool IRReader::parse_value(Type *ty, Value *&v) {
+  skip_blank();
+  std::string_view vname;
+  if (*cur_ == '%') {
+    if (!name('%', vname)) {
+      return false;
+    }
+    auto it = locals_.find(vname);
+    if (it == locals_.end()) {
+      v = new (module_) Value(ty);
+      locals_.emplace(vname, Local{v, false});
+    } else {
+      v = it->second.val;
+    }
+  } else if (*cur_ == '@') {
+    if (!name('@', vname)) {
+      return false;
+    }
+    auto it = globals_.find(vname);
+    if (it == globals_.end()) {
+      return fail("use of undefined value @" + std::string(vname));
+    }
+    v = it->second;
+  } else {
+    Constant *c;
+    if (!parse_constant(ty, c)) {
+      return false;
+    }
+    v = c;
+  }
+  if (v->get_type() != ty) {
+    return fail("'" + std::string(vname) + "' defined with type " +
+                v->get_type()->print() + " but expected " + ty->print());
+  }
+  return true;
+}
+
+bool IRReader::parse_typed_value(Value *&v) {
+  Type *ty;
+  return parse_type(ty) && parse_value(ty, v);
+}
+
+bool IRReader::parse_label(BasicBlock *&bb) {
+  std::string_view label;
+  if (!expect_word("label") || !name('%', label)) {
+    return false;
+  }
+  bb = block_ref(label);
+  return true;
+}
+
+/*!
+ *@brief 按打印出的标号查找基本块，尚未定义时建立游离块
+ *@note label_X 的块名为 X，labelN 为未命名块，其它标号整体作为块名
+ */
+BasicBlock *IRReader::block_ref(std::string_view label) {
+  auto it = blocks_.find(label);
+  if (it != blocks_.end()) {
+    return static_cast<BasicBlock *>(it->second.val);
+  }
+  std::string bname;
+  if (label.substr(0, 6) == std::string_view("label_")) {
+    bname = std::string(label.substr(6));
+  } else if (!is_numbered(label, "label")) {
+    bname = std::string(label);
+  }
+  auto bb = BasicBlock::create(module_, bname, nullptr);
+  blocks_.emplace(label, Local{bb, false});
+  return bb;
+}
+
+/*!
+ *@brief 定义局部名称，替换此前的占位value
+ */
+bool IRReader::define_local(std::string_view vname, Value *v) {
+  if (!is_numbered(vname, "op") && !is_numbered(vname, "arg")) {
+    v->set_name(std::string(vname));
+  }
+  auto it = locals_.find(vname);
+  if (it == locals_.end()) {
+    locals_.emplace(vname, Local{v, true});
+    return true;
+  }
+  if (it->second.defined) {
+    return fail("redefinition of %" + std::string(vname));
+  }
+  Value *ph = it->second.val;
+  if (ph->get_type() != v->get_type()) {
+    return fail("%" + std::string(vname) + " used as " +
+                ph->get_type()->print() + " but defined as " +
+                v->get_type()->print());
+  }
+  ph->replace_all_use_with(v);
+  delete ph;
+  it->second = Local{v, true};
+  return true;
+}
+
+/*!
+ *@brief 读取函数头 R @name(T %a, ...) 并建立函数
+ *@param arg_names 各参数在文本中的名称，声明中没有名称时为空
+ *@note
+ *----------
+ *&emsp; 函数全部先于函数体建立，函数体中的调用可以引用排在后面的函数
+ */
+bool IRReader::parse_header(Function *&f,
+                            std::vector<std::string_view> &arg_names) {
+  Type *ret_ty;
+  std::string_view fname;
+  if (!parse_type(ret_ty) || !name('@', fname) || !expect('(')) {
+    return false;
+  }
+  std::vector<Type *> params;
+  arg_names.clear();
+  if (!consume(')')) {
+    do {
+      Type *ty;
+      if (!parse_type(ty)) {
+        return false;
+      }
+      params.push_back(ty);
+      std::string_view arg;
+      skip_blank();
+      if (*cur_ == '%' && !name('%', arg)) {
+        return false;
+      }
+      arg_names.push_back(arg);
+    } while (consume(','));
+    if (!expect(')')) {
+      return false;
+    }
+  }
+  if (globals_.count(fname)) {
+    return fail("redefinition of @" + std::string(fname));
+  }
+  f = Function::create(module_->get_function_type(ret_ty, params),
+                       std::string(fname), module_);
+  globals_[fname] = f;
+  return true;
+}
+
+/*!
+ *@brief 读取函数体 { ... }
+ *@note 局部名称只在本函数内有效，读取前清空
+ */
+bool IRReader::parse_body(Function *f,
+                          const std::vector<std::string_view> &arg_names) {
+  locals_.clear();
+  blocks_.clear();
+  pred_notes_.clear();
+  size_t i = 0;
+  for (auto arg : f->get_args()) {
+    std::string_view arg_name = arg_names[i++];
+    if (!arg_name.empty() && !define_local(arg_name, arg)) {
+      return false;
+    }
+  }
+  if (!expect('{')) {
+    return false;
+  }
+  for (;;) {
+    skip_space();
+    if (*cur_ == '}') {
+      cur_++;
+      break;
+    }
+    std::string_view label = word();
+    if (label.empty() || *cur_ != ':') {
+      return fail("expected block label");
+    }
+    cur_++;
+    if (!parse_block(f, label)) {
+      return false;
+    }
+  }
+  return finish_function();
+}
+
+/*!
+ *@brief 读取一个基本块：标号之后直到下一个标号或函数结束的指令
+ */
+bool IRReader::parse_block(Function *f, std::string_view label) {
+  auto it = blocks_.find(label);
+  BasicBlock *bb;
+  if (it == blocks_.end()) {
+    bb = block_ref(label);
+    bb->insert_into(f);
+  } else if (it->second.defined) {
+    return fail("label %" + std::string(label) + " defined twice");
+  } else {
+    bb = static_cast<BasicBlock *>(it->second.val);
+    bb->insert_into(f);
+  }
+  blocks_[label].defined = true;
+  std::string_view preds = rest_of_line();
+  if (!preds.empty()) {
+    pred_notes_.emplace_back(bb, preds);
+  }
+
+  for (;;) {
+    skip_space();
+    if (*cur_ == '}' || *cur_ == '\0') {
+      return true;
+    }
+    if (*cur_ != '%') {
+      const char *p = cur_;
+      while (is_ident(*p)) {
+        p++;
+      }
+      if (*p == ':') {
+        return true;
+      }
+    }
+    if (!parse_instruction(bb)) {
+      return false;
+    }
+  }
+}
+
+/*!
+ *@brief 读取一条指令并建立到基本块末尾
+ *@note
+ *----------
+ *&emsp; 有结果的指令以 %name = 开头，结果名在指令建成后定义
+ *&emsp; 浮点算术打印为 add/sub/mul/sdiv float，也接受 fadd 等写法
+ *&emsp; 指令须独占一行
+ */
+bool IRReader::parse_instruction(BasicBlock *bb) {
+  Module *m = module_;
+  std::string_view result;
+  skip_blank();
+  if (*cur_ == '%') {
+    if (!name('%', result) || !expect('=')) {
+      return false;
+    }
+  }
+  std::string_view op = word();
+  Instruction *inst = nullptr;
+  Type *ty;
+  Value *lhs;
+  Value *rhs;
+
+  if (op == "add" || op == "sub" || op == "mul" || op == "sdiv" ||
+      op == "srem" || op == "fadd" || op == "fsub" || op == "fmul" ||
+      op == "fdiv") {
+    if (!parse_type(ty) || !parse_value(ty, lhs) || !expect(',')) {
+      return false;
+    }
+    // 两个操作数类型不同时，打印时第二个操作数带有类型
+    if (at_type() ? !parse_typed_value(rhs) : !parse_value(ty, rhs)) {
+      return false;
+    }
+    bool is_float = ty->is_float_type();
+    if (!is_float && !ty->is_integer_type()) {
+      return fail("arithmetic on " + ty->print());
+    }
+    char k = op[0] == 'f' ? op[1] : op[0];
+    if (k == 'a') {
+      inst = is_float ? BinaryInst::create_fadd(lhs, rhs, bb, m)
+                      : BinaryInst::create_add(lhs, rhs, bb, m);
+    } else if (k == 's' && op.back() == 'b') {
+      inst = is_float ? BinaryInst::create_fsub(lhs, rhs, bb, m)
+                      : BinaryInst::create_sub(lhs, rhs, bb, m);
+    } else if (k == 'm') {
+      inst = is_float ? BinaryInst::create_fmul(lhs, rhs, bb, m)
+                      : BinaryInst::create_mul(lhs, rhs, bb, m);
+    } else if (op == "srem") {
+      if (is_float) {
+        return fail("srem on float");
+      }
+      inst = BinaryInst::create_mod(lhs, rhs, bb, m);
+    } else {
+      inst = is_float ? BinaryInst::create_fdiv(lhs, rhs, bb, m)
+                      : BinaryInst::create_sdiv(lhs, rhs, bb, m);
+    }
+  } else if (op == "icmp" || op == "fcmp") {
+    CmpInst::CmpOp cmp;
+    if (!cmp_op(word(), cmp)) {
+      return fail("unknown comparison predicate");
+    }
+    if (!parse_type(ty) || !parse_value(ty, lhs) || !expect(',') ||
+        !parse_value(ty, rhs)) {
+      return false;
+    }
+    if (ty->is_float_type() != (op == "fcmp")) {
+      return fail(std::string(op) + " on " + ty->print());
+    }
+    inst = CmpInst::create_cmp(cmp, lhs, rhs, bb, m);
+  } else if (op == "br") {
+    BasicBlock *if_true;
+    BasicBlock *if_false;
+    skip_blank();
+    if (std::strncmp(cur_, "label", 5) == 0) {
+      if (!parse_label(if_true)) {
+        return false;
+      }
+      inst = BranchInst::create_br(if_true, bb);
+    } else {
+      if (!parse_type(ty) || ty != m->get_int1_type()) {
+        return fail("branch condition must be i1");
+      }
+      if (!parse_value(ty, lhs) || !expect(',') || !parse_label(if_true) ||
+          !expect(',') || !parse_label(if_false)) {
+        return false;
+      }
+      inst = BranchInst::create_cond_br(lhs, if_true, if_false, bb);
+    }
+  } else if (op == "ret") {
+    Type *ret_ty = bb->get_parent()->get_return_type();
+    if (consume_word("void")) {
+      if (!ret_ty->is_void_type()) {
+        return fail("non-void function returns void");
+      }
+      inst = ReturnInst::create_void_ret(bb);
+    } else {
+      if (!parse_typed_value(lhs)) {
+        return false;
+      }
+      if (lhs->get_type() != ret_ty) {
+        return fail("return type mismatch");
+      }
+      inst = ReturnInst::create_ret(lhs, bb);
+    }
+  } else if (op == "alloca") {
+    if (!parse_type(ty)) {
+      return false;
+    }
+    inst = AllocaInst::create_alloca(ty, bb);
+  } else if (op == "load") {
+    if (!parse_type(ty) || !expect(',') || !parse_typed_value(lhs)) {
+      return false;
+    }
+    if (lhs->get_type() != m->get_pointer_type(ty)) {
+      return fail("load pointer type mismatch");
+    }
+    inst = LoadInst::create_load(ty, lhs, bb);
+  } else if (op == "store") {
+    if (!parse_typed_value(lhs) || !expect(',') || !parse_typed_value(rhs)) {
+      return false;
+    }
+    if (rhs->get_type() != m->get_pointer_type(lhs->get_type())) {
+      return fail("store pointer type mismatch");
+    }
+    inst = StoreInst::create_store(lhs, rhs, bb);
+  } else if (op == "getelementptr") {
+    Value *ptr;
+    std::vector<Value *> idxs;
+    if (!parse_type(ty) || !expect(',') || !parse_typed_value(ptr)) {
+      return false;
+    }
+    if (ptr->get_type() != m->get_pointer_type(ty)) {
+      return fail("getelementptr pointer type mismatch");
+    }
+    while (consume(',')) {
+      Value *idx;
+      if (!parse_typed_value(idx)) {
+        return false;
+      }
+      idxs.push_back(idx);
+    }
+    inst = GetElementPtrInst::create_gep(ptr, idxs, bb);
+  } else if (op == "zext" || op == "fptosi" || op == "sitofp") {
+    Type *dest;
+    if (!parse_typed_value(lhs) || !expect_word("to") || !parse_type(dest)) {
+      return false;
+    }
+    if (op == "zext") {
+      inst = ZextInst::create_zext(lhs, dest, bb);
+    } else if (op == "fptosi") {
+      inst = FpToSiInst::create_fptosi(lhs, dest, bb);
+    } else {
+      inst = SiToFpInst::create_sitofp(lhs, dest, bb);
+    }
+  } else if (op == "phi") {
+    if (!parse_type(ty)) {
+      return false;
+    }
+    auto phi = PhiInst::create_phi(ty, bb);
+    bb->add_instruction(phi);
+    inst = phi;
+    do {
+      std::string_view label;
+      Value *val = nullptr;
+      if (!expect('[')) {
+        return false;
+      }
+      if (!consume_word("undef") && !parse_value(ty, val)) {
+        return false;
+      }
+      if (!expect(',') || !name('%', label) || !expect(']')) {
+        return false;
+      }
+      if (val) {
+        phi->add_phi_pair_operand(val, block_ref(label));
+      }
+    } while (consume(','));
+  } else if (op == "call") {
+    std::string_view fname;
+    if (!parse_type(ty) || !name('@', fname) || !expect('(')) {
+      return false;
+    }
+    auto it = globals_.find(fname);
+    auto callee =
+        it == globals_.end() ? nullptr : dynamic_cast<Function *>(it->second);
+    if (!callee) {
+      return fail("call to undefined function @" + std::string(fname));
+    }
+    if (callee->get_return_type() != ty) {
+      return fail("return type mismatch in call to @" + std::string(fname));
+    }
+    std::vector<Value *> args;
+    if (!consume(')')) {
+      do {
+        Value *arg;
+        if (!parse_typed_value(arg)) {
+          return false;
+        }
+        args.push_back(arg);
+      } while (consume(','));
+      if (!expect(')')) {
+        return false;
+      }
+    }
+    auto fty = callee->get_function_type();
+    if (args.size() != fty->get_num_of_args()) {
+      return fail("wrong number of arguments to @" + std::string(fname));
+    }
+    for (unsigned i = 0; i < args.size(); i++) {
+      if (args[i]->get_type() != fty->get_param_type(i)) {
+        return fail("argument type mismatch in call to @" +
+                    std::string(fname));
+      }
+    }
+    inst = CallInst::create(callee, args, bb);
+  } else {
+    return fail("unknown instruction '" + std::string(op) + "'");
+  }
+
+  if (inst->is_void() != result.empty()) {
+    return fail(result.empty() ? "instruction result must be named"
+                               : "instruction does not produce a value");
+  }
+  if (!result.empty() && !define_local(result, inst)) {
+    return false;
+  }
+  return at_line_end() || fail("expected end of line");
+}
+
+/*!
+ *@brief 检查函数内的引用都已定义，按 preds 注释恢复前驱顺序
+ *@note 注释列出的块与跳转得出的前驱不一致（如手工修改过）时保留后者
+ */
+bool IRReader::finish_function() {
+  for (auto &local : locals_) {
+    if (!local.second.defined) {
+      return fail("use of undefined value %" + std::string(local.first));
+    }
+  }
+  for (auto &block : blocks_) {
+    if (!block.second.defined) {
+      return fail("use of undefined label %" + std::string(block.first));
+    }
+  }
+  for (auto &note : pred_notes_) {
+    std::vector<BasicBlock *> order;
+    std::string_view rest = note.second;
+    bool ok = true;
+    while (ok && !rest.empty()) {
+      size_t begin = rest.find('%');
+      if (begin == std::string_view::npos) {
+        break;
+      }
+      size_t end = begin + 1;
+      while (end < rest.size() && is_ident(rest[end])) {
+        end++;
+      }
+      auto it = blocks_.find(rest.substr(begin + 1, end - begin - 1));
+      ok = it != blocks_.end();
+      if (ok) {
+        order.push_back(static_cast<BasicBlock *>(it->second.val));
+      }
+      rest = rest.substr(end);
+    }
+    auto &preds = note.first->get_pre_basic_blocks();
+    std::vector<BasicBlock *> actual(preds.begin(), preds.end());
+    std::vector<BasicBlock *> sorted = order;
+    std::sort(actual.begin(), actual.end());
+    std::sort(sorted.begin(), sorted.end());
+    if (ok && actual == sorted) {
+      preds.clear();
+      preds.append(order.data(), order.data() + order.size());
+    }
+  }
+  return true;
+}
+
+/*!
+ *@brief 把文本建立到模块中
+ *@note
+ *----------
+ *&emsp; 第一遍按顶层项顺序建立全局变量与函数，跳过函数体，记下其位置
+ *&emsp; 第二遍逐个读取函数体；函数体只引用全局量与本函数内的名称
+ */
+bool IRReader::read_module(Module *m) {
+  module_ = m;
+  error_.clear();
+  globals_.clear();
+  cur_ = text_.c_str();
+  line_ = 1;
+
+  static const char kModuleId[] = "; ModuleID = '";
+  if (text_.compare(0, sizeof(kModuleId) - 1, kModuleId) == 0) {
+    const char *begin = cur_ + sizeof(kModuleId) - 1;
+    const char *end = std::strchr(begin, '\'');
+    if (end) {
+      module_id_.assign(begin, end);
+    }
+  }
+
+  struct Body {
+    Function *f;
+    std::vector<std::string_view> arg_names;
+    const char *pos; //!< 函数体的 {
+    unsigned line;
+  };
+  std::vector<Body> bodies;
+  for (skip_space(); *cur_; skip_space()) {
+    if (*cur_ == '@') {
+      if (!parse_global()) {
+        return false;
+      }
+      continue;
+    }
+    std::string_view w = word();
+    if (w == "source_filename") {
+      if (!expect('=') || !expect('"')) {
+        return false;
+      }
+      const char *end = std::strchr(cur_, '"');
+      if (!end) {
+        return fail("unterminated string");
+      }
+      source_filename_.assign(cur_, end);
+      cur_ = end + 1;
+    } else if (w == "declare" || w == "define") {
+      Body body;
+      if (!parse_header(body.f, body.arg_names)) {
+        return false;
+      }
+      if (w == "declare") {
+        if (!at_line_end()) {
+          return fail("expected end of line");
+        }
+        continue;
+      }
+      skip_space();
+      body.pos = cur_;
+      body.line = line_;
+      // 跳过函数体：直到以 } 开头的行
+      const char *p = std::strchr(cur_, '\n');
+      while (p && p[1] != '}') {
+        line_++;
+        p = std::strchr(p + 1, '\n');
+      }
+      if (!p) {
+        return fail("unterminated function body");
+      }
+      line_++;
+      cur_ = p + 2;
+      bodies.push_back(std::move(body));
+    } else {
+      return fail("unexpected '" +
+                  (w.empty() ? std::string(1, *cur_) : std::string(w)) +
+                  "' at top level");
+    }
+  }
+
+  for (auto &body : bodies) {
+    cur_ = body.pos;
+    line_ = body.line;
+    if (!parse_body(body.f, body.arg_names)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -9,35 +9,61 @@
 
 /*!
  *@brief 打印operands的名称
- *@return 字符串
+ *@param os 输出流
  *@note
  *---------
- *初始化字符串
  *&emsp; **if** 如果打印类型，打印类型数值
  *&emsp; **if** 如果属于全局变量，打印@+对应名称
  *&emsp;&emsp; **else if** 如果属于函数量，打印@+对应名称
  *&emsp;&emsp; **else if** 如果属于常量，打印对应名称
  *&emsp;&emsp; **else** 如果属于普通变量，打印%+对应名称
- *&emsp; 返回字符串
  */
-std::string print_as_op(Value *v, bool print_ty) {
-  std::string op_ir;
+void print_as_op(IROStream &os, Value *v, bool print_ty) {
   if (print_ty) {
-    op_ir += v->get_type()->print();
-    op_ir += " ";
+    os << v->get_type()->print() << ' ';
   }
 
   if (dynamic_cast<GlobalVariable *>(v)) {
-    op_ir += "@" + v->get_name();
+    os << '@' << v->get_name();
   } else if (dynamic_cast<Function *>(v)) {
-    op_ir += "@" + v->get_name();
+    os << '@' << v->get_name();
   } else if (dynamic_cast<Constant *>(v)) {
-    op_ir += v->print();
+    v->print(os);
   } else {
-    op_ir += "%" + v->get_name();
+    os << '%';
+    print_name(os, v);
   }
+}
 
-  return op_ir;
+/*!
+ *@brief 局部value的打印名称，不含%
+ *@param os 输出流
+ *@note
+ *---------
+ *&emsp; 基本块：有名称打印label_+名称，同名块中第二个起再加.+序号；
+ *&emsp; 否则label+编号
+ *&emsp; 其余有名称的value打印名称本身
+ *&emsp; 未命名的参数打印arg+编号，指令打印op+编号
+ */
+void print_name(IROStream &os, Value *v) {
+  if (v->get_type()->is_label_type()) {
+    if (v->has_name()) {
+      os << "label_" << v->get_name();
+      if (v->get_slot() != 0 && v->get_slot() != Value::kNoSlot) {
+        os << '.' << v->get_slot();
+      }
+    } else {
+      os << "label" << v->get_slot();
+    }
+    return;
+  }
+  if (v->has_name()) {
+    os << v->get_name();
+  } else if (v->get_slot() == Value::kNoSlot) {
+    os << "<badref>";
+  } else {
+    os << (dynamic_cast<Argument *>(v) ? "arg" : "op") << v->get_slot();
+  }
 }
 
 /*!
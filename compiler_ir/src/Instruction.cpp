@@ -17,8 +17,8 @@
 #include <algorithm>
 
 Instruction::Instruction(Type *ty, OpID id, unsigned num_ops,
-                        BasicBlock *parent)
-    : User(ty, "", num_ops),parent_(parent), op_id_(id), num_ops_(num_ops)
+                        BasicBlock *parent, Use *inline_ops, unsigned inline_cap)
+    : User(ty, "", num_ops, inline_ops, inline_cap),parent_(parent), op_id_(id), num_ops_(num_ops)
 {
     parent_->add_instruction(this);
 }
@@ -45,7 +45,7 @@ bool Instruction::isStaticCalculable() {
 
 BinaryInst::BinaryInst(Type *ty, OpID id, Value *v1, Value *v2, 
                     BasicBlock *bb)
-    : Instruction(ty, id, 2, bb)
+    : InlineOperandInst(ty, id, 2, bb)
 {
     set_operand(0, v1);
     set_operand(1, v2);
@@ -61,47 +61,47 @@ void BinaryInst::assertValid()
 
 BinaryInst *BinaryInst::create_add(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::add, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::add, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_sub(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::sub, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::sub, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_mul(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::mul, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::mul, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_sdiv(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::sdiv, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::sdiv, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_mod(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_int32_type(m), Instruction::mod, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_int32_type(m), Instruction::mod, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fadd(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::add, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::add, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fsub(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::sub, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::sub, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fmul(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::mul, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::mul, v1, v2, bb);
 }
 
 BinaryInst *BinaryInst::create_fdiv(Value *v1, Value *v2, BasicBlock *bb, Module *m)
 {
-    return new BinaryInst(Type::get_float_type(m), Instruction::sdiv, v1, v2, bb);
+    return new (m) BinaryInst(Type::get_float_type(m), Instruction::sdiv, v1, v2, bb);
 }
 bool BinaryInst::isStaticCalculable() {
     auto cl = dynamic_cast<ConstantInt *>(get_operand(0));
@@ -109,27 +109,25 @@ bool BinaryInst::isStaticCalculable() {
     return cl != nullptr && cr != nullptr;
 }
 
-std::string BinaryInst::print()
+void BinaryInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += ", ";
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << ", ";
     if (Type::is_eq_type(this->get_operand(0)->get_type(), this->get_operand(1)->get_type()))
     {
-        instr_ir += print_as_op(this->get_operand(1), false);
+        print_as_op(os, this->get_operand(1), false);
     }
     else
     {
-        instr_ir += print_as_op(this->get_operand(1), true);
+        print_as_op(os, this->get_operand(1), true);
     }
-    return instr_ir;
 }
 
 int BinaryInst::calculate() {
@@ -149,7 +147,7 @@ int BinaryInst::calculate() {
 
 CmpInst::CmpInst(Type *ty, CmpOp op, Value *lhs, Value *rhs, 
             BasicBlock *bb)
-    : Instruction(ty, Instruction::cmp, 2, bb), cmp_op_(op)
+    : InlineOperandInst(ty, Instruction::cmp, 2, bb), cmp_op_(op)
 {
     set_operand(0, lhs);
     set_operand(1, rhs);
@@ -166,57 +164,55 @@ void CmpInst::assertValid()
 CmpInst *CmpInst::create_cmp(CmpOp op, Value *lhs, Value *rhs, 
                         BasicBlock *bb, Module *m)
 {
-    return new CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
+    return new (m) CmpInst(m->get_int1_type(), op, lhs, rhs, bb);
 }
 
 // 【关键修复】正确区分 icmp 和 fcmp 的打印逻辑
-std::string CmpInst::print()
+void CmpInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
+    os << "%";
+    print_name(os, this);
+    os << " = ";
     
     // 检查操作数类型
     Type* opType = this->get_operand(0)->get_type();
     if (opType->is_float_type()) {
-        instr_ir += "fcmp ";
+        os << "fcmp ";
         switch (this->cmp_op_) {
-            case GT: instr_ir += "ogt"; break;
-            case GE: instr_ir += "oge"; break;
-            case LT: instr_ir += "olt"; break;
-            case LE: instr_ir += "ole"; break;
-            case EQ: instr_ir += "oeq"; break;
-            case NE: instr_ir += "one"; break;
-            default: instr_ir += "false"; break;
+            case GT: os << "ogt"; break;
+            case GE: os << "oge"; break;
+            case LT: os << "olt"; break;
+            case LE: os << "ole"; break;
+            case EQ: os << "oeq"; break;
+            case NE: os << "one"; break;
+            default: os << "false"; break;
         }
     } else {
-        instr_ir += "icmp ";
+        os << "icmp ";
         switch (this->cmp_op_) {
-            case GT: instr_ir += "sgt"; break;
-            case GE: instr_ir += "sge"; break;
-            case LT: instr_ir += "slt"; break;
-            case LE: instr_ir += "sle"; break;
-            case EQ: instr_ir += "eq"; break;
-            case NE: instr_ir += "ne"; break;
-            default: instr_ir += "false"; break;
+            case GT: os << "sgt"; break;
+            case GE: os << "sge"; break;
+            case LT: os << "slt"; break;
+            case LE: os << "sle"; break;
+            case EQ: os << "eq"; break;
+            case NE: os << "ne"; break;
+            default: os << "false"; break;
         }
     }
 
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += ", ";
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << ", ";
     if (Type::is_eq_type(this->get_operand(0)->get_type(), this->get_operand(1)->get_type()))
     {
-        instr_ir += print_as_op(this->get_operand(1), false);
+        print_as_op(os, this->get_operand(1), false);
     }
     else
     {
-        instr_ir += print_as_op(this->get_operand(1), true);
+        print_as_op(os, this->get_operand(1), true);
     }
-    return instr_ir;
 }
 
 bool CmpInst::isStaticCalculable() {
@@ -254,7 +250,7 @@ CallInst::CallInst(Function *func, std::vector<Value *> args, BasicBlock *bb)
 
 CallInst *CallInst::create(Function *func, std::vector<Value *> args, BasicBlock *bb)
 {
-    return new CallInst(func, args, bb);
+    return new (func->get_parent()) CallInst(func, args, bb);
 }
 
 FunctionType *CallInst::get_function_type() const
@@ -262,65 +258,122 @@ FunctionType *CallInst::get_function_type() const
     return static_cast<FunctionType *>(get_operand(0)->get_type());
 }
 
-std::string CallInst::print()
+void CallInst::print(IROStream &os)
 {
-    std::string instr_ir;
     if( !this->is_void() )
     {
-        instr_ir += "%";
-        instr_ir += this->get_name();
-        instr_ir += " = ";
+        os << "%";
+        print_name(os, this);
+        os << " = ";
     }
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
-    instr_ir += this->get_function_type()->get_return_type()->print();    
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
+    os << this->get_function_type()->get_return_type()->print();    
     
-    instr_ir += " ";
+    os << " ";
     assert(dynamic_cast<Function *>(this->get_operand(0)) && "Wrong call operand function");
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += "(";
+    print_as_op(os, this->get_operand(0), false);
+    os << "(";
     for (int i = 1; i < (int)this->get_num_operand(); i++)
     {
         if( i > 1 )
-            instr_ir += ", ";
-        instr_ir += this->get_operand(i)->get_type()->print();
-        instr_ir += " ";
-        instr_ir += print_as_op(this->get_operand(i), false);
+            os << ", ";
+        os << this->get_operand(i)->get_type()->print();
+        os << " ";
+        print_as_op(os, this->get_operand(i), false);
     }
-    instr_ir += ")";
-    return instr_ir;
+    os << ")";
 }
 
 BranchInst::BranchInst(Value *cond, BasicBlock *if_true, BasicBlock *if_false,
                     BasicBlock *bb)
-    : Instruction(Type::get_void_type(if_true->get_module()), Instruction::br, 3, bb)
+    : InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::br, 3, bb)
 {
     set_operand(0, cond);
     set_operand(1, if_true);
     set_operand(2, if_false);
+    link_edges();
 }
 
 BranchInst::BranchInst(BasicBlock *if_true, BasicBlock *bb)
-    : Instruction(Type::get_void_type(if_true->get_module()), Instruction::br, 1, bb)
+    : InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::br, 1, bb)
 {
     set_operand(0, if_true);
+    link_edges();
 }
 
 BranchInst *BranchInst::create_cond_br(Value *cond, BasicBlock *if_true, BasicBlock *if_false,
                                     BasicBlock *bb)
 {
-    if_true->add_pre_basic_block(bb);
-    if_false->add_pre_basic_block(bb);
-    bb->add_succ_basic_block(if_false);
-    bb->add_succ_basic_block(if_true);
-    return new BranchInst(cond, if_true, if_false, bb);
+    return new (bb->get_module()) BranchInst(cond, if_true, if_false, bb);
 }
 
 BranchInst *BranchInst::create_br(BasicBlock *if_true, BasicBlock *bb)
 {
-    if_true->add_pre_basic_block(bb);
-    bb->add_succ_basic_block(if_true);
-    return new BranchInst(if_true, bb);
+    return new (bb->get_module()) BranchInst(if_true, bb);
+}
+
+BasicBlock *BranchInst::get_successor(unsigned i) const
+{
+    assert(i < get_num_successors() && "successor index out of range");
+    return static_cast<BasicBlock *>(get_operand(successor_operand(i)));
+}
+
+void BranchInst::set_successor(unsigned i, BasicBlock *bb)
+{
+    assert(i < get_num_successors() && "successor index out of range");
+    if (linked_)
+    {
+        get_successor(i)->remove_pre_basic_block(parent_);
+        bb->add_pre_basic_block(parent_);
+    }
+    set_operand(successor_operand(i), bb);
+}
+
+void BranchInst::link_edges()
+{
+    if (linked_ || parent_ == nullptr)
+    {
+        return;
+    }
+    for (unsigned i = 0; i < get_num_successors(); i++)
+    {
+        get_successor(i)->add_pre_basic_block(parent_);
+    }
+    linked_ = true;
+}
+
+void BranchInst::unlink_edges()
+{
+    if (!linked_)
+    {
+        return;
+    }
+    for (unsigned i = 0; i < get_num_successors(); i++)
+    {
+        get_successor(i)->remove_pre_basic_block(parent_);
+    }
+    linked_ = false;
+}
+
+void BranchInst::transplant(std::map<Value *, Value *> ptMap)
+{
+    for (unsigned i = 0; i < get_num_operand(); i++)
+    {
+        auto it = ptMap.find(get_operand(i));
+        if (it == ptMap.end())
+        {
+            continue;
+        }
+        if (is_cond_br() && i == 0)
+        {
+            set_operand(i, it->second);
+        }
+        else
+        {
+            set_successor(is_cond_br() ? i - 1 : i, static_cast<BasicBlock *>(it->second));
+        }
+    }
 }
 
 bool BranchInst::is_cond_br() const
@@ -328,42 +381,40 @@ bool BranchInst::is_cond_br() const
     return (int)get_num_operand() == 3;
 }
 
-std::string BranchInst::print()
+void BranchInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), true);
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
+    print_as_op(os, this->get_operand(0), true);
     if( is_cond_br() )
     {
-        instr_ir += ", ";
-        instr_ir += print_as_op(this->get_operand(1), true);
-        instr_ir += ", ";
-        instr_ir += print_as_op(this->get_operand(2), true);
+        os << ", ";
+        print_as_op(os, this->get_operand(1), true);
+        os << ", ";
+        print_as_op(os, this->get_operand(2), true);
     }
-    return instr_ir;
 }
 
 ReturnInst::ReturnInst(Value *val, BasicBlock *bb)
-    : Instruction(Type::get_void_type(bb->get_module()), Instruction::ret, 1, bb)
+    : InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::ret, 1, bb)
 {
     set_operand(0, val);
 }
 
 ReturnInst::ReturnInst(BasicBlock *bb)
-    : Instruction(Type::get_void_type(bb->get_module()), Instruction::ret, 0, bb)
+    : InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::ret, 0, bb)
 {
 
 }
 
 ReturnInst *ReturnInst::create_ret(Value *val, BasicBlock *bb)
 {
-    return new ReturnInst(val, bb);
+    return new (bb->get_module()) ReturnInst(val, bb);
 }
 
 ReturnInst *ReturnInst::create_void_ret(BasicBlock *bb)
 {
-    return new ReturnInst(bb);
+    return new (bb->get_module()) ReturnInst(bb);
 }
 
 bool ReturnInst::is_void_ret() const
@@ -371,23 +422,20 @@ bool ReturnInst::is_void_ret() const
     return (int)get_num_operand() == 0;
 }
 
-std::string ReturnInst::print()
+void ReturnInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
     if ( !is_void_ret() )
     {
-        instr_ir += this->get_operand(0)->get_type()->print();
-        instr_ir += " ";
-        instr_ir += print_as_op(this->get_operand(0), false);
+        os << this->get_operand(0)->get_type()->print();
+        os << " ";
+        print_as_op(os, this->get_operand(0), false);
     }
     else
     {
-        instr_ir += "void";
+        os << "void";
     }
-    
-    return instr_ir;
 }
 
 GetElementPtrInst::GetElementPtrInst(Value *ptr, std::vector<Value *> idxs, BasicBlock *bb)
@@ -429,33 +477,31 @@ Type *GetElementPtrInst::get_element_type() const
 
 GetElementPtrInst *GetElementPtrInst::create_gep(Value *ptr, std::vector<Value *> idxs, BasicBlock *bb)
 {
-    return new GetElementPtrInst(ptr, idxs, bb);
+    return new (bb->get_module()) GetElementPtrInst(ptr, idxs, bb);
 }
 
-std::string GetElementPtrInst::print()
+void GetElementPtrInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
     assert(this->get_operand(0)->get_type()->is_pointer_type());
-    instr_ir += this->get_operand(0)->get_type()->get_pointer_element_type()->print();
-    instr_ir += ", ";
+    os << this->get_operand(0)->get_type()->get_pointer_element_type()->print();
+    os << ", ";
     for (int i = 0; i < (int)this->get_num_operand(); i++)
     {
         if( i > 0 )
-            instr_ir += ", ";
-        instr_ir += this->get_operand(i)->get_type()->print();
-        instr_ir += " ";
-        instr_ir += print_as_op(this->get_operand(i), false);
+            os << ", ";
+        os << this->get_operand(i)->get_type()->print();
+        os << " ";
+        print_as_op(os, this->get_operand(i), false);
     }
-    return instr_ir;
 }
 
 StoreInst::StoreInst(Value *val, Value *ptr, BasicBlock *bb)
-    : Instruction(Type::get_void_type(bb->get_module()), Instruction::store, 2, bb)
+    : InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::store, 2, bb)
 {
     set_operand(0, val);
     set_operand(1, ptr);
@@ -463,24 +509,22 @@ StoreInst::StoreInst(Value *val, Value *ptr, BasicBlock *bb)
 
 StoreInst *StoreInst::create_store(Value *val, Value *ptr, BasicBlock *bb)
 {
-    return new StoreInst(val, ptr, bb);
+    return new (bb->get_module()) StoreInst(val, ptr, bb);
 }
 
-std::string StoreInst::print()
+void StoreInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += ", ";
-    instr_ir += print_as_op(this->get_operand(1), true);
-    return instr_ir;
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << ", ";
+    print_as_op(os, this->get_operand(1), true);
 }
 
 LoadInst::LoadInst(Type *ty, Value *ptr, BasicBlock *bb)
-    : Instruction(ty, Instruction::load, 1, bb)
+    : InlineOperandInst(ty, Instruction::load, 1, bb)
 {
     assert(ptr->get_type()->is_pointer_type());
     set_operand(0, ptr);
@@ -488,7 +532,7 @@ LoadInst::LoadInst(Type *ty, Value *ptr, BasicBlock *bb)
 
 LoadInst *LoadInst::create_load(Type *ty, Value *ptr, BasicBlock *bb)
 {
-    return new LoadInst(ty, ptr, bb);
+    return new (ty->get_module()) LoadInst(ty, ptr, bb);
 }
 
 Type *LoadInst::get_load_type() const
@@ -496,20 +540,18 @@ Type *LoadInst::get_load_type() const
     return static_cast<PointerType *>(get_operand(0)->get_type())->get_element_type();
 }
 
-std::string LoadInst::print()
+void LoadInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
     assert(this->get_operand(0)->get_type()->is_pointer_type());
-    instr_ir += this->get_operand(0)->get_type()->get_pointer_element_type()->print();
-    instr_ir += ",";
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), true);
-    return instr_ir;
+    os << this->get_operand(0)->get_type()->get_pointer_element_type()->print();
+    os << ",";
+    os << " ";
+    print_as_op(os, this->get_operand(0), true);
 }
 
 AllocaInst::AllocaInst(Type *ty, BasicBlock *bb)
@@ -518,36 +560,47 @@ AllocaInst::AllocaInst(Type *ty, BasicBlock *bb)
 
 }
 
+AllocaInst::AllocaInst(Type *ty)
+    : Instruction(PointerType::get(ty), Instruction::alloca, 0), alloca_ty_(ty)
+{
+
+}
+
 AllocaInst *AllocaInst::create_alloca(Type *ty, BasicBlock *bb)
 {
-    return new AllocaInst(ty, bb);
+    return new (ty->get_module()) AllocaInst(ty, bb);
+}
+
+AllocaInst *AllocaInst::create_entry_alloca(Type *ty, BasicBlock *entry)
+{
+    auto inst = new (ty->get_module()) AllocaInst(ty);
+    entry->add_instr_after_alloca(inst);
+    return inst;
 }
 Type *AllocaInst::get_alloca_type() const
 {
     return alloca_ty_;
 }
 
-std::string AllocaInst::print()
+void AllocaInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
-    instr_ir += get_alloca_type()->print();
-    return instr_ir;    
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
+    os << get_alloca_type()->print();
 }
 
 ZextInst::ZextInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
-    : Instruction(ty, op, 1, bb), dest_ty_(ty)
+    : InlineOperandInst(ty, op, 1, bb), dest_ty_(ty)
 {
     set_operand(0, val);
 }
 
 ZextInst *ZextInst::create_zext(Value *val, Type *ty, BasicBlock *bb)
 {
-    return new ZextInst(Instruction::zext, val, ty, bb);
+    return new (ty->get_module()) ZextInst(Instruction::zext, val, ty, bb);
 }
 
 Type *ZextInst::get_dest_type() const
@@ -555,33 +608,31 @@ Type *ZextInst::get_dest_type() const
     return dest_ty_;
 }
 
-std::string ZextInst::print()
+void ZextInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
+    os << "%";
+    print_name(os, this);
+    os << " = ";
     // 【修改】强制打印 zext 关键字，防止 get_instr_op_name 返回空
-    instr_ir += "zext"; 
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += " to ";
-    instr_ir += this->get_dest_type()->print();
-    return instr_ir; 
+    os << "zext"; 
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << " to ";
+    os << this->get_dest_type()->print();
 }
 
 // 【新增】FpToSiInst 实现
 FpToSiInst::FpToSiInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
-    : Instruction(ty, op, 1, bb), dest_ty_(ty)
+    : InlineOperandInst(ty, op, 1, bb), dest_ty_(ty)
 {
     set_operand(0, val);
 }
 
 FpToSiInst *FpToSiInst::create_fptosi(Value *val, Type *ty, BasicBlock *bb)
 {
-    return new FpToSiInst(Instruction::fptosi, val, ty, bb);
+    return new (ty->get_module()) FpToSiInst(Instruction::fptosi, val, ty, bb);
 }
 
 Type *FpToSiInst::get_dest_type() const
@@ -589,32 +640,30 @@ Type *FpToSiInst::get_dest_type() const
     return dest_ty_;
 }
 
-std::string FpToSiInst::print()
+void FpToSiInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += "fptosi"; // 硬编码
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += " to ";
-    instr_ir += this->get_dest_type()->print();
-    return instr_ir; 
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << "fptosi"; // 硬编码
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << " to ";
+    os << this->get_dest_type()->print();
 }
 
 // 【新增】SiToFpInst 实现
 SiToFpInst::SiToFpInst(OpID op, Value *val, Type *ty, BasicBlock *bb)
-    : Instruction(ty, op, 1, bb), dest_ty_(ty)
+    : InlineOperandInst(ty, op, 1, bb), dest_ty_(ty)
 {
     set_operand(0, val);
 }
 
 SiToFpInst *SiToFpInst::create_sitofp(Value *val, Type *ty, BasicBlock *bb)
 {
-    return new SiToFpInst(Instruction::sitofp, val, ty, bb);
+    return new (ty->get_module()) SiToFpInst(Instruction::sitofp, val, ty, bb);
 }
 
 Type *SiToFpInst::get_dest_type() const
@@ -622,20 +671,18 @@ Type *SiToFpInst::get_dest_type() const
     return dest_ty_;
 }
 
-std::string SiToFpInst::print()
+void SiToFpInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += "sitofp"; // 硬编码
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
-    instr_ir += print_as_op(this->get_operand(0), false);
-    instr_ir += " to ";
-    instr_ir += this->get_dest_type()->print();
-    return instr_ir; 
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << "sitofp"; // 硬编码
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
+    print_as_op(os, this->get_operand(0), false);
+    os << " to ";
+    os << this->get_dest_type()->print();
 }
 
 PhiInst::PhiInst(OpID op, std::vector<Value *> vals, std::vector<BasicBlock *> val_bbs, Type *ty, BasicBlock *bb)
@@ -653,41 +700,42 @@ PhiInst *PhiInst::create_phi( Type *ty, BasicBlock *bb)
 {
     std::vector<Value *> vals;
     std::vector<BasicBlock *> val_bbs;
-    return new PhiInst(Instruction::phi, vals, val_bbs, ty, bb);
+    return new (ty->get_module()) PhiInst(Instruction::phi, vals, val_bbs, ty, bb);
 }
 
-std::string PhiInst::print()
+void PhiInst::print(IROStream &os)
 {
-    std::string instr_ir;
-    instr_ir += "%";
-    instr_ir += this->get_name();
-    instr_ir += " = ";
-    instr_ir += this->get_module()->get_instr_op_name( this->get_instr_type() );
-    instr_ir += " ";
-    instr_ir += this->get_operand(0)->get_type()->print();
-    instr_ir += " ";
+    os << "%";
+    print_name(os, this);
+    os << " = ";
+    os << this->get_module()->get_instr_op_name( this->get_instr_type() );
+    os << " ";
+    os << this->get_operand(0)->get_type()->print();
+    os << " ";
     for (int i = 0; i < (int)this->get_num_operand()/2; i++)
     {
         if( i > 0 )
-            instr_ir += ", ";
-        instr_ir += "[ ";
-        instr_ir += print_as_op(this->get_operand(2*i), false);
-        instr_ir += ", ";
-        instr_ir += print_as_op(this->get_operand(2*i+1), false);
-        instr_ir += " ]";
+            os << ", ";
+        os << "[ ";
+        print_as_op(os, this->get_operand(2*i), false);
+        os << ", ";
+        print_as_op(os, this->get_operand(2*i+1), false);
+        os << " ]";
     }
     if ( (int)this->get_num_operand()/2 < (int)(this->get_parent()->get_pre_basic_blocks().size()) )
     {
+        auto ops = this->get_operands();
         for ( auto pre_bb : this->get_parent()->get_pre_basic_blocks() )
         {
-            if (std::find(this->get_operands().begin(), this->get_operands().end(), static_cast<Value *>(pre_bb)) == this->get_operands().end())
+            if (std::find(ops.begin(), ops.end(), static_cast<Value *>(pre_bb)) == ops.end())
             {
                 // find a pre_bb is not in phi
-                instr_ir += ", [ undef, " +print_as_op(pre_bb, false)+" ]";
+                os << ", [ undef, ";
+                print_as_op(os, pre_bb, false);
+                os << " ]";
             }
         }
     }
-    return instr_ir; 
 }
 
 std::list<std::pair<Value *, BasicBlock *>> PhiInst::getValueBBPair() {
@@ -698,7 +746,7 @@ std::list<std::pair<Value *, BasicBlock *>> PhiInst::getValueBBPair() {
     return ret;
 }
 
-BranchInst::BranchInst(int op_num, BasicBlock *bb): Instruction(Type::get_void_type(bb->get_module()), Instruction::br, op_num, bb){}
+BranchInst::BranchInst(int op_num, BasicBlock *bb): InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::br, op_num, bb){}
 
 BasicBlock *BranchInst::getTrueBB() const {
     if (is_cond_br()) {
@@ -712,5 +760,5 @@ BasicBlock *BranchInst::getFalseBB() const {
     assert(is_cond_br() && "Only condition branch has a false block");
     return dynamic_cast<BasicBlock *>(get_operand(2));
 };
-ReturnInst::ReturnInst(BasicBlock *bb, size_t num_op): Instruction(Type::get_void_type(bb->get_module()), Instruction::ret, num_op, bb){};
-StoreInst::StoreInst(BasicBlock *bb): Instruction(Type::get_void_type(bb->get_module()), Instruction::store, 2, bb){};
\ No newline at end of file
+ReturnInst::ReturnInst(BasicBlock *bb, size_t num_op): InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::ret, num_op, bb){};
+StoreInst::StoreInst(BasicBlock *bb): InlineOperandInst(Type::get_void_type(bb->get_module()), Instruction::store, 2, bb){};
\ No newline at end of file
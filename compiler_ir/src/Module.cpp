@@ -4,18 +4,24 @@
  *@version 1.0.0
  *@date 2022-10-04
  */
+#include "Constant.h"
 #include "Module.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
 #include <utility>
+#include <vector>
 
 Module::Module(std::string name) : module_name_(std::move(name)) {
   /// @brief 创建类型指针对象
   /// @param name
-  void_ty_ = new Type(Type::VoidTyID, this);
-  label_ty_ = new Type(Type::LabelTyID, this);
-  int1_ty_ = new IntegerType(1, this);
-  int32_ty_ = new IntegerType(32, this);
-  float32_ty_ = new FloatType(this);
+  void_ty_ = new (this) Type(Type::VoidTyID, this);
+  label_ty_ = new (this) Type(Type::LabelTyID, this);
+  int1_ty_ = new (this) IntegerType(1, this);
+  int32_ty_ = new (this) IntegerType(32, this);
+  float32_ty_ = new (this) FloatType(this);
 
   /// @brief id 与 字符串的映射添加
   instr_id2string_.insert({Instruction::ret, "ret"});
@@ -41,13 +47,26 @@ Module::Module(std::string name) : module_name_(std::move(name)) {
 /**
  * @brief Destroy the Module:: Module object 析构函数
  *
+ * @note 释放内存池中的全部对象，包括已从函数中摘除但未 delete 的指令
+ * @note 先断开所有操作数的 use 链，之后各对象的析构不再访问其它对象，
+ *       可以按任意顺序析构；最后整块归还内存
  */
 Module::~Module() {
-  delete void_ty_;
-  delete label_ty_;
-  delete int1_ty_;
-  delete int32_ty_;
-  delete float32_ty_;
+  arena_.for_each_live([](void *obj, ArenaKind kind) {
+    if (kind == kValueBlock) {
+      if (auto user = dynamic_cast<User *>(static_cast<Value *>(obj))) {
+        user->drop_all_operands();
+      }
+    }
+  });
+  arena_.for_each_live([](void *obj, ArenaKind kind) {
+    if (kind == kValueBlock) {
+      static_cast<Value *>(obj)->~Value();
+    } else {
+      static_cast<Type *>(obj)->~Type();
+    }
+  });
+  arena_.release();
 }
 /**
  * @brief Get the void type object，获取一个构建好的void类型指针
@@ -80,10 +99,12 @@ IntegerType *Module::get_int32_type() { return int32_ty_; }
  * @return PointerType*
  */
 PointerType *Module::get_pointer_type(Type *contained) {
-  if (pointer_map_.find(contained) == pointer_map_.end()) {
-    pointer_map_[contained] = new PointerType(contained);
+  std::lock_guard<std::mutex> guard(type_mutex_);
+  auto &slot = pointer_map_[contained];
+  if (!slot) {
+    slot = new (this) PointerType(contained);
   }
-  return pointer_map_[contained];
+  return slot;
 }
 /**
  * @brief Get the array type object，获取一个构建好的array类型指针
@@ -93,11 +114,82 @@ PointerType *Module::get_pointer_type(Type *contained) {
  * @return ArrayType*
  */
 ArrayType *Module::get_array_type(Type *contained, unsigned num_elements) {
-  if (array_map_.find({contained, num_elements}) == array_map_.end()) {
-    array_map_[{contained, num_elements}] =
-        new ArrayType(contained, num_elements);
+  std::lock_guard<std::mutex> guard(type_mutex_);
+  auto &slot = array_map_[{contained, num_elements}];
+  if (!slot) {
+    slot = new (this) ArrayType(contained, num_elements);
   }
-  return array_map_[{contained, num_elements}];
+  return slot;
+}
+/**
+ * @brief Get the function type object，获取一个构建好的函数类型指针
+ *
+ * @param result 返回类型
+ * @param params 参数类型列表
+ * @return FunctionType*
+ * @note 成员类型本身已唯一化，按成员指针序列查表即可判定结构相同
+ */
+FunctionType *Module::get_function_type(Type *result,
+                                        const std::vector<Type *> &params) {
+  std::vector<Type *> key;
+  key.reserve(params.size() + 1);
+  key.push_back(result);
+  key.insert(key.end(), params.begin(), params.end());
+  std::lock_guard<std::mutex> guard(type_mutex_);
+  auto &slot = function_map_[std::move(key)];
+  if (!slot) {
+    slot = new (this) FunctionType(result, params);
+  }
+  return slot;
+}
+/**
+ * @brief 获取唯一化的整数常量
+ *
+ * @param ty 整数类型（i1 或 i32）
+ * @param val 常量值
+ * @return ConstantInt*
+ * @note 池中常量会被多个函数体引用，标记为共享
+ */
+ConstantInt *Module::get_constant_int(IntegerType *ty, int val) {
+  std::lock_guard<std::mutex> guard(constant_mutex_);
+  auto &slot = int_pool_[{ty, val}];
+  if (!slot) {
+    slot = new (this) ConstantInt(ty, val);
+    slot->set_shared();
+  }
+  return slot;
+}
+/**
+ * @brief 获取唯一化的浮点常量
+ *
+ * @param val 常量值
+ * @return ConstantFloat*
+ */
+ConstantFloat *Module::get_constant_float(float val) {
+  uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  std::lock_guard<std::mutex> guard(constant_mutex_);
+  auto &slot = float_pool_[bits];
+  if (!slot) {
+    slot = new (this) ConstantFloat(float32_ty_, val);
+    slot->set_shared();
+  }
+  return slot;
+}
+/**
+ * @brief 获取唯一化的零初始化常量
+ *
+ * @param ty 常量类型
+ * @return ConstantZero*
+ */
+ConstantZero *Module::get_constant_zero(Type *ty) {
+  std::lock_guard<std::mutex> guard(constant_mutex_);
+  auto &slot = zero_pool_[ty];
+  if (!slot) {
+    slot = new (this) ConstantZero(ty);
+    slot->set_shared();
+  }
+  return slot;
 }
 /**
  * @brief Get the int32 ptr type object，获取一个构建好的integer32指针类型指针
@@ -121,58 +213,167 @@ FloatType *Module::get_float_type() { return float32_ty_; }
 PointerType *Module::get_float_ptr_type() {
   return get_pointer_type(float32_ty_);
 }
+/**
+ * @brief 驻留value名称
+ *
+ * @param name 非空名称
+ * @return const std::string*
+ */
+const std::string *Module::intern_name(const std::string &name) {
+  std::lock_guard<std::mutex> guard(name_mutex_);
+  return &*names_.insert(name).first;
+}
 /**
  * @brief 添加函数
  *
  * @param f 函数指针
+ * @note 同时登记到名称索引，同名时保留先登记者
  */
-void Module::add_function(Function *f) { function_list_.push_back(f); }
+void Module::add_function(Function *f) {
+  std::lock_guard<std::mutex> guard(symbol_mutex_);
+  function_list_.push_back(f);
+  value_sym_.emplace(f->get_name(), f);
+}
 /**
- * @brief Get the functions object，获取函数列表
+ * @brief Get the function object，按名称查找函数
  *
- * @return std::list<Function *> 函数列表
+ * @param name 函数名称
+ * @return Function* 函数指针，不存在时为nullptr
  */
-std::list<Function *> Module::get_functions() { return function_list_; }
+Function *Module::get_function(const std::string &name) {
+  std::lock_guard<std::mutex> guard(symbol_mutex_);
+  auto it = value_sym_.find(name);
+  if (it == value_sym_.end()) {
+    return nullptr;
+  }
+  return dynamic_cast<Function *>(it->second);
+}
 /**
  * @brief 添加全局量
  *
  * @param g 全局量指针
+ * @note 同时登记到名称索引，同名时保留先登记者
  */
 void Module::add_global_variable(GlobalVariable *g) {
+  std::lock_guard<std::mutex> guard(symbol_mutex_);
   global_list_.push_back(g);
+  value_sym_.emplace(g->get_name(), g);
 }
 /**
- * @brief Get the global variable object，获取全局量指针数组
+ * @brief 删除全局量
  *
- * @return std::list<GlobalVariable *> 全局量指针数组
+ * @param g 全局量指针
+ * @note 名称索引仍指向该全局量时一并删除
  */
-std::list<GlobalVariable *> Module::get_global_variable() {
-  return global_list_;
+void Module::delete_global_variable(GlobalVariable *g) {
+  std::lock_guard<std::mutex> guard(symbol_mutex_);
+  global_list_.remove(g);
+  auto it = value_sym_.find(g->get_name());
+  if (it != value_sym_.end() && it->second == g) {
+    value_sym_.erase(it);
+  }
 }
 /**
- * @brief Set the print name object，修正模块管理的函数下的名称
+ * @brief Get the global variable object，按名称查找全局量
+ *
+ * @param name 全局量名称
+ * @return GlobalVariable* 全局量指针，不存在时为nullptr
+ */
+GlobalVariable *Module::get_global_variable(const std::string &name) {
+  std::lock_guard<std::mutex> guard(symbol_mutex_);
+  auto it = value_sym_.find(name);
+  if (it == value_sym_.end()) {
+    return nullptr;
+  }
+  return dynamic_cast<GlobalVariable *>(it->second);
+}
+/**
+ * @brief Set the print name object，为各函数中未命名的value编号
  *
  */
 void Module::set_print_name() {
-  for (auto func : this->get_functions()) {
-    func->set_instr_name();
+  for (auto func : this->function_list_) {
+    func->number_slots();
   }
   return;
 }
 /**
- * @brief 打印中间代码
+ * @brief 只打印全局变量
  *
- * @return std::string
+ * @param os 输出流
  */
-std::string Module::print() {
-  std::string module_ir;
+void Module::print_globals(IROStream &os) {
   for (auto global_val : this->global_list_) {
-    module_ir += global_val->print();
-    module_ir += "\n";
+    global_val->print(os);
+    os << '\n';
   }
-  for (auto func : this->function_list_) {
-    module_ir += func->print();
-    module_ir += "\n";
+}
+
+/**
+ * @brief 打印中间代码到输出流
+ *
+ * @param os 输出流
+ * @param jobs 并行渲染函数体的线程数
+ * @note 先打印全局量；函数之间互不依赖（编号只写各自的value），
+ *       并行时工作线程按原子下标领取函数渲染到各自的缓冲，
+ *       主线程按函数顺序等待并写出已完成的缓冲
+ */
+void Module::print(IROStream &os, int jobs) {
+  print_globals(os);
+  std::vector<Function *> funcs(function_list_.begin(), function_list_.end());
+  size_t workers = jobs > 1 ? static_cast<size_t>(jobs) : 1;
+  if (workers > funcs.size()) {
+    workers = funcs.size();
+  }
+  if (workers <= 1) {
+    for (auto func : funcs) {
+      func->print(os);
+      os << '\n';
+    }
+    return;
+  }
+
+  std::vector<std::string> bufs(funcs.size());
+  std::vector<char> done(funcs.size(), 0); // 由done_mutex保护
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < workers; t++) {
+    threads.emplace_back([&]() {
+      for (size_t i = next++; i < funcs.size(); i = next++) {
+        IROStream buf;
+        funcs[i]->print(buf);
+        buf << '\n';
+        bufs[i] = buf.take();
+        {
+          std::lock_guard<std::mutex> guard(done_mutex);
+          done[i] = 1;
+        }
+        done_cv.notify_one();
+      }
+    });
   }
-  return module_ir;
+  for (size_t i = 0; i < funcs.size(); i++) {
+    {
+      std::unique_lock<std::mutex> lock(done_mutex);
+      done_cv.wait(lock, [&]() { return done[i] != 0; });
+    }
+    os << bufs[i];
+    std::string().swap(bufs[i]);
+  }
+  for (auto &th : threads) {
+    th.join();
+  }
+}
+
+/**
+ * @brief 打印中间代码
+ *
+ * @return std::string
+ */
+std::string Module::print() {
+  IROStream os;
+  print(os);
+  return os.take();
 }
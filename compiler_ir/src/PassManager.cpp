@@ -0,0 +1,196 @@
+/*!
+ *@file PassManager.cpp
+ *@brief 函数级优化过程管理定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "PassManager.h"
+#include "ConstantFolder.h"
+#include "DominatorTree.h"
+#include "StackColoring.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+/*!
+ *@brief 常量折叠：操作数全为常量的算术、比较与类型转换替换为常量
+ *@note 按布局顺序处理，前面折叠出的常量可继续参与后面的折叠
+ */
+int run_constfold(Function *f) {
+  ConstantFolder folder(f->get_parent());
+  std::vector<Instruction *> instrs;
+  int changed = 0;
+  for (auto bb : f->get_basic_blocks()) {
+    instrs.assign(bb->get_instructions().begin(),
+                  bb->get_instructions().end());
+    for (auto inst : instrs) {
+      Constant *c = nullptr;
+      auto op = inst->get_instr_type();
+      if (inst->isBinary()) {
+        c = folder.fold_binary(op, inst->get_operand(0), inst->get_operand(1));
+      } else if (inst->is_cmp()) {
+        c = folder.fold_cmp(static_cast<CmpInst *>(inst)->get_cmp_op(),
+                            inst->get_operand(0), inst->get_operand(1));
+      } else if (op == Instruction::zext || op == Instruction::fptosi ||
+                 op == Instruction::sitofp) {
+        c = folder.fold_cast(op, inst->get_operand(0), inst->get_type());
+      }
+      if (c) {
+        inst->replace_all_use_with(c);
+        bb->delete_instr(inst);
+        changed++;
+      }
+    }
+  }
+  return changed;
+}
+
+/*!
+ *@brief 死代码删除：删除结果无人使用且没有副作用的指令
+ *@note
+ *----------
+ *&emsp; store、call 与终结指令保留，其余指令的结果不被使用即可删除
+ *&emsp; 删除后其操作数可能随之无人使用，以工作表继续处理；
+ *&emsp; 入表标记以指令的稠密编号为下标
+ */
+int run_dce(Function *f) {
+  auto removable = [](Instruction *inst) {
+    return !inst->is_store() && !inst->is_call() && !inst->isTerminator() &&
+           inst->get_use_list().empty();
+  };
+  std::vector<char> queued(f->get_instr_number_bound(), 0);
+  std::vector<Instruction *> worklist;
+  for (auto bb : f->get_basic_blocks()) {
+    for (auto inst : bb->get_instructions()) {
+      if (removable(inst)) {
+        queued[inst->get_number()] = 1;
+        worklist.push_back(inst);
+      }
+    }
+  }
+  int changed = 0;
+  while (!worklist.empty()) {
+    Instruction *inst = worklist.back();
+    worklist.pop_back();
+    std::vector<Instruction *> ops;
+    for (unsigned i = 0; i < inst->get_num_operand(); i++) {
+      if (auto op = dynamic_cast<Instruction *>(inst->get_operand(i))) {
+        ops.push_back(op);
+      }
+    }
+    inst->get_parent()->delete_instr(inst);
+    changed++;
+    for (auto op : ops) {
+      if (!queued[op->get_number()] && removable(op)) {
+        queued[op->get_number()] = 1;
+        worklist.push_back(op);
+      }
+    }
+  }
+  return changed;
+}
+
+int run_stack_coloring(Function *f) { return StackColoring(f).run(); }
+
+/*!
+ *@brief 在标准错误上打印支配树与支配边界，不修改函数
+ *@note 取函数缓存的结果，之前的过程没有改变 CFG 时不重新计算
+ */
+int run_print_domtree(Function *f) {
+  f->number_slots();
+  IROStream os(std::cerr);
+  f->get_dominator_tree()->print(os);
+  return 0;
+}
+
+int run_print_postdomtree(Function *f) {
+  f->number_slots();
+  IROStream os(std::cerr);
+  f->get_post_dominator_tree()->print(os);
+  return 0;
+}
+
+} // namespace
+
+const std::vector<PassManager::PassInfo> &PassManager::registry() {
+  static const std::vector<PassInfo> passes = {
+      {"constfold", "fold arithmetic, comparisons and casts of constants",
+       run_constfold},
+      {"dce", "delete unused instructions without side effects", run_dce},
+      {"stack-coloring", "merge allocas whose lifetimes do not overlap",
+       run_stack_coloring},
+      {"print-domtree", "print dominator tree and dominance frontiers",
+       run_print_domtree},
+      {"print-postdomtree",
+       "print post-dominator tree and post-dominance frontiers",
+       run_print_postdomtree},
+  };
+  return passes;
+}
+
+bool PassManager::add(const std::string &name) {
+  for (auto &info : registry()) {
+    if (name == info.name) {
+      passes_.push_back(Entry{&info, 0.0, 0});
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PassManager::add_list(const std::string &list) {
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t comma = list.find(',', start);
+    if (comma == std::string::npos) {
+      comma = list.size();
+    }
+    if (comma > start && !add(list.substr(start, comma - start))) {
+      return false;
+    }
+    start = comma + 1;
+  }
+  return true;
+}
+
+/*!
+ *@brief 依次执行序列中的过程
+ *@note 声明（没有函数体）跳过；计时包括过程处理全部函数的时间
+ */
+void PassManager::run(Module *m) {
+  for (auto &entry : passes_) {
+    auto start = std::chrono::steady_clock::now();
+    for (auto f : m->get_functions()) {
+      if (!f->is_declaration()) {
+        entry.changed += entry.info->run(f);
+      }
+    }
+    if (time_passes_) {
+      entry.seconds += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    }
+  }
+}
+
+void PassManager::print_timing(std::ostream &os) const {
+  double total = 0;
+  for (auto &entry : passes_) {
+    total += entry.seconds;
+  }
+  char line[128];
+  for (auto &entry : passes_) {
+    std::snprintf(line, sizeof(line), "%10.4fs %6.1f%% %10ld  %s\n",
+                  entry.seconds,
+                  total > 0 ? entry.seconds * 100 / total : 0.0,
+                  entry.changed, entry.info->name);
+    os << line;
+  }
+  std::snprintf(line, sizeof(line), "%10.4fs %6.1f%% %10s  total\n", total,
+                100.0, "");
+  os << line;
+}
@@ -0,0 +1,197 @@
+/*!
+ *@file SSABuilder.cpp
+ *@brief 边生成边构造SSA的定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "SSABuilder.h"
+#include "Constant.h"
+
+/*!
+ *@brief 记录变量在基本块中的当前定义
+ */
+void SSABuilder::write_variable(Value *var, BasicBlock *bb, Value *val) {
+  current_def_[var][bb] = val;
+}
+
+/*!
+ *@brief 读取变量在基本块末尾处的值
+ *@note
+ *----------
+ *&emsp; 块内有定义直接返回
+ *&emsp; 未封闭的块放置不完整的 phi，封闭时补全
+ *&emsp; 只有一个前驱的块沿前驱查找，多个前驱的块放置 phi 并逐个前驱读取
+ *&emsp; 沿前驱的查找用显式栈完成，长的 if 链不会导致深递归；
+ *&emsp; 途经的每个块都记下结果，之后的读取直接命中
+ */
+Value *SSABuilder::read_variable(Value *var, Type *ty, BasicBlock *bb) {
+  struct Frame {
+    BasicBlock *bb;
+    PhiInst *phi; //!< 单前驱块为 nullptr
+    std::vector<BasicBlock *> preds;
+    size_t next;
+  };
+  auto &defs = current_def_[var];
+  std::vector<Frame> work;
+  Value *val = nullptr;
+  BasicBlock *cur = bb;
+
+  while (true) {
+    // 向前驱方向查找 cur 的值，需要等待前驱结果时压栈
+    if (cur) {
+      auto it = defs.find(cur);
+      auto &preds = cur->get_pre_basic_blocks();
+      if (it != defs.end()) {
+        val = it->second;
+      } else if (!is_sealed(cur)) {
+        PhiInst *phi = new_phi(var, ty, cur);
+        incomplete_phis_[cur].push_back({var, phi});
+        defs[cur] = phi;
+        val = phi;
+      } else if (preds.empty()) {
+        val = undef(ty);
+        defs[cur] = val;
+      } else if (preds.size() == 1) {
+        work.push_back({cur, nullptr, {}, 0});
+        cur = preds.front();
+        continue;
+      } else {
+        // 先记下 phi 再读前驱，回到本块的路径会得到 phi 本身
+        PhiInst *phi = new_phi(var, ty, cur);
+        defs[cur] = phi;
+        work.push_back({cur, phi, {preds.begin(), preds.end()}, 0});
+        cur = work.back().preds[0];
+        continue;
+      }
+      cur = nullptr;
+    }
+
+    // val 为栈顶块当前所等待前驱的值
+    if (work.empty()) return val;
+    Frame &fr = work.back();
+    if (!fr.phi) {
+      defs[fr.bb] = val;
+      work.pop_back();
+      continue;
+    }
+    fr.phi->add_phi_pair_operand(val, fr.preds[fr.next]);
+    if (++fr.next < fr.preds.size()) {
+      cur = fr.preds[fr.next];
+      continue;
+    }
+    val = try_remove_trivial_phi(fr.phi);
+    defs[fr.bb] = val;
+    work.pop_back();
+  }
+}
+
+/*!
+ *@brief 封闭基本块
+ *@note
+ *----------
+ *先标记为已封闭，补全操作数时对不完整 phi 的删除检查才会生效
+ */
+void SSABuilder::seal_block(BasicBlock *bb) {
+  if (!sealed_.insert(bb).second) {
+    return;
+  }
+  auto it = incomplete_phis_.find(bb);
+  if (it == incomplete_phis_.end()) {
+    return;
+  }
+  auto pending = std::move(it->second);
+  incomplete_phis_.erase(it);
+  for (auto &p : pending) {
+    add_phi_operands(p.first, p.second);
+  }
+}
+
+PhiInst *SSABuilder::new_phi(Value *var, Type *ty, BasicBlock *bb) {
+  PhiInst *phi = PhiInst::create_phi(ty, bb);
+  bb->add_instr_begin(phi);
+  phi_var_[phi] = var;
+  return phi;
+}
+
+Value *SSABuilder::add_phi_operands(Value *var, PhiInst *phi) {
+  BasicBlock *bb = phi->get_parent();
+  std::vector<BasicBlock *> preds(bb->get_pre_basic_blocks().begin(),
+                                  bb->get_pre_basic_blocks().end());
+  for (auto pred : preds) {
+    phi->add_phi_pair_operand(read_variable(var, phi->get_type(), pred), pred);
+  }
+  return try_remove_trivial_phi(phi);
+}
+
+/*!
+ *@brief 删除平凡 phi
+ *@note
+ *----------
+ *&emsp; 操作数中除 phi 自身外只有一个不同值时，phi 可由该值替换
+ *&emsp; 替换后，原先使用该 phi 的其它 phi 也可能变得平凡，用工作表继续检查
+ *&emsp; 未封闭块中的 phi 操作数不全，不做检查
+ */
+Value *SSABuilder::try_remove_trivial_phi(PhiInst *phi) {
+  std::unordered_map<Value *, Value *> forward; //!< 本次删除的 phi -> 替换值
+  std::vector<PhiInst *> work{phi};
+
+  while (!work.empty()) {
+    PhiInst *p = work.back();
+    work.pop_back();
+    if (forward.count(p) || !is_sealed(p->get_parent())) {
+      continue;
+    }
+
+    Value *same = nullptr;
+    bool trivial = true;
+    for (unsigned i = 0; i < p->get_num_operand(); i += 2) {
+      Value *op = p->get_operand(i);
+      if (op == same || op == p) {
+        continue;
+      }
+      if (same) {
+        trivial = false;
+        break;
+      }
+      same = op;
+    }
+    if (!trivial) {
+      continue;
+    }
+    if (!same) {
+      same = undef(p->get_type());
+    }
+
+    std::vector<PhiInst *> users;
+    for (auto &use : p->get_use_list()) {
+      auto user = dynamic_cast<PhiInst *>(use.val_);
+      if (user && user != p) {
+        users.push_back(user);
+      }
+    }
+    p->replace_all_use_with(same);
+    for (auto &def : current_def_[phi_var_[p]]) {
+      if (def.second == p) {
+        def.second = same;
+      }
+    }
+    p->get_parent()->delete_instr(p);
+    phi_var_.erase(p);
+    forward[p] = same;
+    work.insert(work.end(), users.begin(), users.end());
+  }
+
+  Value *result = phi;
+  for (auto it = forward.find(result); it != forward.end(); it = forward.find(result)) {
+    result = it->second;
+  }
+  return result;
+}
+
+Value *SSABuilder::undef(Type *ty) {
+  if (ty->is_float_type()) {
+    return ConstantFloat::get(0.0f, module_);
+  }
+  return ConstantInt::get(0, module_);
+}
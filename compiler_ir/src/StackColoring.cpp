@@ -0,0 +1,241 @@
+/*!
+ *@file StackColoring.cpp
+ *@brief 栈槽合并定义文件
+ *@version 1.0.0
+ *@date 2026-10-19
+ */
+
+#include "StackColoring.h"
+
+namespace {
+
+using BitSet = std::vector<uint64_t>;
+
+inline void bit_set(BitSet &bs, int i) { bs[i >> 6] |= (uint64_t)1 << (i & 63); }
+inline void bit_reset(BitSet &bs, int i) { bs[i >> 6] &= ~((uint64_t)1 << (i & 63)); }
+inline bool bit_test(const BitSet &bs, int i) { return (bs[i >> 6] >> (i & 63)) & 1; }
+
+} // namespace
+
+/*!
+ *@brief 返回指令直接访问的槽位编号
+ *@param inst 待检查的指令
+ *@return load 的源地址或 store 的目标地址对应的槽位编号，否则为 -1
+ */
+int StackColoring::slot_of(Instruction *inst) {
+  Value *ptr = nullptr;
+  if (inst->is_load()) {
+    ptr = inst->get_operand(0);
+  } else if (inst->is_store()) {
+    ptr = inst->get_operand(1);
+  } else {
+    return -1;
+  }
+  auto it = slot_id_.find(ptr);
+  return it == slot_id_.end() ? -1 : it->second;
+}
+
+/*!
+ *@brief 收集可合并的 alloca
+ *@note
+ *----------
+ *&emsp; 入口块中的 alloca 作为候选
+ *&emsp; 沿 use 链检查，地址出现在 load/store 指针位置之外（如作为存储的值、
+ *&emsp; 调用实参）的槽位视为逃逸，不参与合并
+ */
+void StackColoring::collect_slots() {
+  std::vector<AllocaInst *> candidates;
+  std::unordered_map<Value *, bool> escaped;
+  for (auto inst : func_->get_entry_block()->get_instructions()) {
+    if (auto alloca = dynamic_cast<AllocaInst *>(inst)) {
+      candidates.push_back(alloca);
+      escaped[alloca] = false;
+    }
+  }
+  for (auto alloca : candidates) {
+    for (auto &use : alloca->get_use_list()) {
+      auto inst = dynamic_cast<Instruction *>(use.val_);
+      bool direct = inst && ((inst->is_load() && use.arg_no_ == 0) ||
+                             (inst->is_store() && use.arg_no_ == 1));
+      if (!direct) {
+        escaped[alloca] = true;
+      }
+    }
+  }
+  for (auto alloca : candidates) {
+    if (!escaped[alloca]) {
+      slot_id_[alloca] = (int)slots_.size();
+      slots_.push_back(alloca);
+    }
+  }
+}
+
+/*!
+ *@brief 计算各基本块出入口的活跃槽位
+ *@note
+ *----------
+ *&emsp; 槽位在某点活跃：存在一条到达 load 的路径且途中没有写该槽位的 store
+ *&emsp; use[b]：块内先读后写的槽位；def[b]：块内写过的槽位
+ *&emsp; 逆序迭代 in = use | (out & ~def)，out = 各后继 in 之并，直到不动点
+ *&emsp; 各集合以块编号为下标存放在数组中
+ */
+void StackColoring::compute_liveness() {
+  size_t words = (slots_.size() + 63) / 64;
+  size_t num_blocks = func_->get_block_number_bound();
+  std::vector<BitSet> use(num_blocks, BitSet(words, 0));
+  std::vector<BitSet> def(num_blocks, BitSet(words, 0));
+  live_in_.assign(num_blocks, BitSet(words, 0));
+  live_out_.assign(num_blocks, BitSet(words, 0));
+  for (auto bb : func_->get_basic_blocks()) {
+    BitSet &u = use[bb->get_number()];
+    BitSet &d = def[bb->get_number()];
+    for (auto inst : bb->get_instructions()) {
+      int s = slot_of(inst);
+      if (s < 0) {
+        continue;
+      }
+      if (inst->is_load() && !bit_test(d, s)) {
+        bit_set(u, s);
+      } else if (inst->is_store()) {
+        bit_set(d, s);
+      }
+    }
+  }
+
+  std::vector<BasicBlock *> order(func_->get_basic_blocks().rbegin(),
+                                  func_->get_basic_blocks().rend());
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto bb : order) {
+      BitSet &out = live_out_[bb->get_number()];
+      for (auto succ : bb->get_succ_basic_blocks()) {
+        const BitSet &succ_in = live_in_[succ->get_number()];
+        for (size_t w = 0; w < words; w++) {
+          out[w] |= succ_in[w];
+        }
+      }
+      BitSet &in = live_in_[bb->get_number()];
+      const BitSet &u = use[bb->get_number()];
+      const BitSet &d = def[bb->get_number()];
+      for (size_t w = 0; w < words; w++) {
+        uint64_t v = u[w] | (out[w] & ~d[w]);
+        if (v != in[w]) {
+          in[w] = v;
+          changed = true;
+        }
+      }
+    }
+  }
+}
+
+/*!
+ *@brief 构建槽位冲突关系
+ *@note
+ *----------
+ *&emsp; 逆序扫描每个块，维护当前活跃集合
+ *&emsp; store 写槽位 s 时，与此后仍活跃的其它槽位冲突，合并后这次写会破坏它们
+ *&emsp; 入口处不活跃的槽位，生命周期都从某个 store 开始，因此这样判定已足够
+ */
+void StackColoring::build_interference() {
+  size_t words = (slots_.size() + 63) / 64;
+  interfere_.assign(slots_.size(), BitSet(words, 0));
+  for (auto bb : func_->get_basic_blocks()) {
+    BitSet live = live_out_[bb->get_number()];
+    auto &instrs = bb->get_instructions();
+    for (auto it = instrs.rbegin(); it != instrs.rend(); ++it) {
+      int s = slot_of(*it);
+      if (s < 0) {
+        continue;
+      }
+      if ((*it)->is_store()) {
+        for (size_t w = 0; w < words; w++) {
+          interfere_[s][w] |= live[w];
+        }
+        for (size_t t = 0; t < slots_.size(); t++) {
+          if (bit_test(live, (int)t)) {
+            bit_set(interfere_[t], s);
+          }
+        }
+        bit_reset(live, s);
+      } else {
+        bit_set(live, s);
+      }
+    }
+  }
+}
+
+/*!
+ *@brief 执行栈槽合并
+ *@return 被删除的 alloca 数量
+ *@note
+ *----------
+ *&emsp; 按出现顺序贪心着色：槽位放入第一个同类型且与全部成员都不冲突的颜色
+ *&emsp; 同一颜色的槽位改为访问该颜色的第一个 alloca，其余 alloca 删除
+ */
+int StackColoring::run() {
+  if (func_->get_basic_blocks().empty()) {
+    return 0;
+  }
+  collect_slots();
+  if (slots_.size() < 2) {
+    return 0;
+  }
+  compute_liveness();
+  build_interference();
+
+  size_t words = (slots_.size() + 63) / 64;
+  const BitSet &entry_live = live_in_[func_->get_entry_block()->get_number()];
+
+  struct Color {
+    AllocaInst *rep;
+    BitSet members;
+  };
+  std::vector<Color> colors;
+  std::vector<AllocaInst *> replace(slots_.size(), nullptr);
+  for (size_t i = 0; i < slots_.size(); i++) {
+    // 可能在初始化前被读取的槽位保持独立，避免读到其它变量的值
+    if (bit_test(entry_live, (int)i)) {
+      continue;
+    }
+    Color *target = nullptr;
+    for (auto &c : colors) {
+      if (c.rep->get_alloca_type() != slots_[i]->get_alloca_type()) {
+        continue;
+      }
+      bool conflict = false;
+      for (size_t w = 0; w < words && !conflict; w++) {
+        conflict = (interfere_[i][w] & c.members[w]) != 0;
+      }
+      if (!conflict) {
+        target = &c;
+        break;
+      }
+    }
+    if (target) {
+      bit_set(target->members, (int)i);
+      replace[i] = target->rep;
+    } else {
+      colors.push_back({slots_[i], BitSet(words, 0)});
+      bit_set(colors.back().members, (int)i);
+    }
+  }
+
+  int merged = 0;
+  for (auto bb : func_->get_basic_blocks()) {
+    for (auto inst : bb->get_instructions()) {
+      int s = slot_of(inst);
+      if (s >= 0 && replace[s]) {
+        inst->set_operand(inst->is_load() ? 0 : 1, replace[s]);
+      }
+    }
+  }
+  BasicBlock *entry = func_->get_entry_block();
+  for (size_t i = 0; i < slots_.size(); i++) {
+    if (replace[i]) {
+      entry->delete_instr(slots_[i]);
+      merged++;
+    }
+  }
+  return merged;
+}
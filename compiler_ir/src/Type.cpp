@@ -25,11 +25,20 @@ Type::Type(TypeID tid, Module *m) {
  * @return Module* 模块指针
  */
 Module *Type::get_module() { return m_; }
+
+void *Type::operator new(size_t size, Module *m) {
+  return m->get_arena().allocate(size, kTypeBlock);
+}
+
+void Type::operator delete(void *p) { Arena::deallocate(p); }
+
+void Type::operator delete(void *p, Module *) { Arena::deallocate(p); }
 /**
  * @brief 判断两个类型是否一致
  *
  * @return true 是
  * @return false 不是
+ * @note 派生类型都由模块按结构唯一化，指针相等即结构相同
  */
 bool Type::is_eq_type(Type *ty1, Type *ty2) { return ty1 == ty2; }
 /**
@@ -156,9 +165,18 @@ int Type::get_size(bool extended) {
 /**
  * @brief 打印类型
  *
+ * @return const std::string& 缓存的文本表示
+ */
+const std::string &Type::print() {
+  std::call_once(spelling_once_, [this] { spelling_ = render(); });
+  return spelling_;
+}
+/**
+ * @brief 生成类型的文本表示
+ *
  * @return std::string，字符串
  */
-std::string Type::print() {
+std::string Type::render() {
   std::string type_ir;
   switch (this->get_type_id()) {
   case VoidTyID:
@@ -226,7 +244,7 @@ IntegerType::IntegerType(unsigned num_bits, Module *m)
  * @return IntegerType*
  */
 IntegerType *IntegerType::get(unsigned num_bits, Module *m) {
-  return new IntegerType(num_bits, m);
+  return num_bits == 1 ? m->get_int1_type() : m->get_int32_type();
 }
 /**
  * @brief Get the num bits object，获取整数类型对应的位数
@@ -243,7 +261,7 @@ unsigned IntegerType::get_num_bits() { return num_bits_; }
  * @return 创建对象本身
  */
 FunctionType::FunctionType(Type *result, std::vector<Type *> params)
-    : Type(Type::FunctionTyID, nullptr) {
+    : Type(Type::FunctionTyID, result->get_module()) {
   assert(is_valid_return_type(result) && "Invalid return type for function!");
   result_ = result;
 
@@ -278,10 +296,10 @@ bool FunctionType::is_valid_argument_type(Type *ty) {
  *
  * @param result 返回参数类型指针
  * @param params 参数类型指针数组
- * @return FunctionType* 函数类型指针
+ * @return FunctionType* 函数类型指针，签名相同时返回同一对象
  */
 FunctionType *FunctionType::get(Type *result, std::vector<Type *> params) {
-  return new FunctionType(result, params);
+  return result->get_module()->get_function_type(result, params);
 }
 /**
  * @brief Get the num of args object，获取参数个数
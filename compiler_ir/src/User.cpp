@@ -7,33 +7,94 @@
 
 #include "User.h"
 #include <cassert>
+#include <new>
+#include <utility>
 
 /*!
  *@brief User的构造函数
  *@param ty 类型
  *@param name User名称
  *@param num_ops value的位置
+ *@param inline_ops 对象之后的use空间
+ *@param inline_cap 内联空间可容纳的use个数
  *@return 当前对象本身
  *@note
  *---------
- *初始化operands数组全为nullptr
+ *初始化operands数组全为nullptr，每个位置是一个未挂链的use
+ *有内联空间时原地构造use，否则在hung_off_中构造
  */
-User::User(Type *ty, const std::string &name, unsigned num_ops)
-    : Value(ty, name), num_ops_(num_ops) {
-  operands_.resize(num_ops_, nullptr);
+User::User(Type *ty, const std::string &name, unsigned num_ops,
+           Use *inline_ops, unsigned inline_cap)
+    : Value(ty, name), num_ops_(num_ops),
+      inline_cap_(inline_ops ? inline_cap : 0) {
+  if (inline_cap_) {
+    assert(num_ops_ <= inline_cap_ && "too many operands for inline storage");
+    operands_ = inline_ops;
+    for (unsigned i = 0; i < num_ops_; i++) {
+      new (&operands_[i]) Use(this, i);
+    }
+    return;
+  }
+  hung_off_.reserve(num_ops_);
+  for (unsigned i = 0; i < num_ops_; i++) {
+    hung_off_.emplace_back(this, i);
+  }
+  operands_ = hung_off_.data();
+}
+
+User::~User() {
+  remove_use_of_ops();
+  if (inline_cap_) {
+    for (unsigned i = 0; i < num_ops_; i++) {
+      operands_[i].~Use();
+    }
+  }
+}
+
+/*!
+ *@brief 为对象及其后的n个use分配空间
+ *@note
+ *---------
+ *use数组紧跟对象，与对象同属一个内存池块，释放对象时一并归还
+ */
+void *User::allocate_with_operands(size_t size, Module *m, unsigned n) {
+  return Value::operator new(size + n * sizeof(Use), m);
+}
+
+/*!
+ *@brief 把内联的操作数搬到hung_off_
+ *@note
+ *---------
+ *use经移动构造搬到新数组，链上位置随之转移
+ */
+void User::move_to_hung_off() {
+  hung_off_.reserve(num_ops_ + 1);
+  for (unsigned i = 0; i < num_ops_; i++) {
+    hung_off_.emplace_back(std::move(operands_[i]));
+    operands_[i].~Use();
+  }
+  inline_cap_ = 0;
+  operands_ = hung_off_.data();
 }
 
 /*!
  *@brief 获得包含value指针的数组
- *@return 返回User维护的Value数组
+ *@return 操作数的副本
  */
-std::vector<Value *> &User::get_operands() { return operands_; }
+std::vector<Value *> User::get_operands() const {
+  std::vector<Value *> ops;
+  ops.reserve(num_ops_);
+  for (unsigned i = 0; i < num_ops_; i++) {
+    ops.push_back(operands_[i].get());
+  }
+  return ops;
+}
 
 /*!
  *@brief 获得数组中的第i个value数值指针
  *@return 获得数组中的第i个value数值常量指针
  */
-Value *User::get_operand(unsigned i) const { return operands_[i]; }
+Value *User::get_operand(unsigned i) const { return operands_[i].get(); }
 
 /*!
  *@brief 设置数组中的第i个value数值指针
@@ -41,16 +102,13 @@ Value *User::get_operand(unsigned i) const { return operands_[i]; }
  *--------
  *设置数组中的第i个value数值常量指针
  *设置界限检查，查看索引i是否超限
+ *原位置已有操作数时，先从其use list中摘除对应的use
  *--------
- *&emsp; value数组尾插入一个value
- *&emsp; 为value添加一个use关系
- *&emsp; 计数加一
+ *&emsp; 该位置的use节点改挂到新value的use链，O(1)
  */
 void User::set_operand(unsigned i, Value *v) {
   assert(i < num_ops_ && "set_operand out of index");
-  // assert(operands_[i] == nullptr && "ith operand is not null");
-  operands_[i] = v;
-  v->add_use(this, i);
+  operands_[i].set(v);
 }
 
 /*!
@@ -63,8 +121,17 @@ void User::set_operand(unsigned i, Value *v) {
  *&emsp; 计数加一
  */
 void User::add_operand(Value *v) {
-  operands_.push_back(v);
-  v->add_use(this, num_ops_);
+  if (inline_cap_ && num_ops_ == inline_cap_) {
+    move_to_hung_off();
+  }
+  if (inline_cap_) {
+    new (&operands_[num_ops_]) Use(this, num_ops_);
+  } else {
+    // 扩容时use节点经移动构造搬到新数组，链上位置随之转移
+    hung_off_.emplace_back(this, num_ops_);
+    operands_ = hung_off_.data();
+  }
+  operands_[num_ops_].set(v);
   num_ops_++;
 }
 
@@ -86,8 +153,20 @@ unsigned User::get_num_operand() const { return num_ops_; }
  *在operands表中删除对于本对象的使用
  */
 void User::remove_use_of_ops() {
-  for (auto op : operands_) {
-    op->remove_use(this);
+  for (unsigned i = 0; i < num_ops_; i++) {
+    operands_[i].unlink();
+  }
+}
+
+/*!
+ *@brief 把全部操作数置空
+ *@note
+ *--------
+ *从各value的use链摘除并清空used_，模块析构时先对所有user调用
+ */
+void User::drop_all_operands() {
+  for (unsigned i = 0; i < num_ops_; i++) {
+    operands_[i].set(nullptr);
   }
 }
 
@@ -98,13 +177,43 @@ void User::remove_use_of_ops() {
  *@note
  *--------
  *遍历operands表索引范围，删除对于本user的使用
- *删除本表的相关operands
+ *删除本表的相关operands，修正后续operands的use序号
  *修改operands_size
  */
 void User::remove_operands(int index1, int index2) {
   for (int i = index1; i <= index2; i++) {
-    operands_[i]->remove_use(this);
+    operands_[i].unlink();
+  }
+  // 其后的use经移动赋值前移，序号同步修正
+  unsigned cnt = index2 - index1 + 1;
+  for (unsigned i = index2 + 1; i < num_ops_; i++) {
+    operands_[i - cnt] = std::move(operands_[i]);
+    operands_[i - cnt].arg_no_ = i - cnt;
+  }
+  if (inline_cap_) {
+    for (unsigned i = num_ops_ - cnt; i < num_ops_; i++) {
+      operands_[i].~Use();
+    }
+  } else {
+    hung_off_.erase(hung_off_.end() - cnt, hung_off_.end());
+  }
+  num_ops_ -= cnt;
+}
+
+/*!
+ *@brief 复制另一user的全部操作数
+ *@param src 源user
+ *@note
+ *--------
+ *本user已有的位置直接改写，不足的位置追加
+ */
+void User::copy_operands_from(const User *src) {
+  unsigned n = src->get_num_operand();
+  for (unsigned i = 0; i < n; i++) {
+    if (i < num_ops_) {
+      set_operand(i, src->get_operand(i));
+    } else {
+      add_operand(src->get_operand(i));
+    }
   }
-  operands_.erase(operands_.begin() + index1, operands_.begin() + index2 + 1);
-  num_ops_ = operands_.size();
 }
@@ -6,8 +6,11 @@
  */
 
 #include <cassert>
+#include <cstdint>
+#include <mutex>
 
 #include "BasicBlock.h"
+#include "Module.h"
 #include "Type.h"
 #include "User.h"
 #include "Value.h"
@@ -17,65 +20,224 @@
  *@param name value名称
  *@return 当前对象本身
  */
-Value::Value(Type *ty, const std::string &name) : type_(ty), name_(name) {}
+Value::Value(Type *ty, const std::string &name)
+    : type_(ty), slot_(kNoSlot) {
+  set_name(name);
+}
+
+void *Value::operator new(size_t size, Module *m) {
+  return m->get_arena().allocate(size, kValueBlock);
+}
+
+void Value::operator delete(void *p) { Arena::deallocate(p); }
+
+void Value::operator delete(void *p, Module *) { Arena::deallocate(p); }
+
+namespace {
+/// 共享value的use list分段锁，按对象地址选锁
+std::mutex use_list_locks[64];
+
+std::mutex &use_list_lock(const Value *v) {
+  return use_list_locks[(reinterpret_cast<uintptr_t>(v) >> 4) % 64];
+}
+
+/// 被使用的value为共享value时加锁，否则不做任何事
+class UseListGuard {
+public:
+  explicit UseListGuard(const Value *v, bool shared)
+      : lock_(shared ? &use_list_lock(v) : nullptr) {
+    if (lock_) {
+      lock_->lock();
+    }
+  }
+  ~UseListGuard() {
+    if (lock_) {
+      lock_->unlock();
+    }
+  }
+
+private:
+  std::mutex *lock_;
+};
+
+/// 链上节点搬到新地址后，修正前后节点指向它的指针
+inline void relink(Use *use) {
+  if (use->prev_) {
+    *use->prev_ = use;
+  }
+  if (use->next_) {
+    use->next_->prev_ = &use->next_;
+  }
+}
+} // namespace
+
+/*!
+ *@brief use的移动构造
+ *@note
+ *---------
+ *接管other的全部字段与链上位置，other变为未挂链状态
+ */
+Use::Use(Use &&other) noexcept
+    : val_(other.val_), arg_no_(other.arg_no_), used_(other.used_) {
+  if (!used_) {
+    return;
+  }
+  // 邻居节点可能正被其它线程摘除，是否挂链也要在锁内判断
+  UseListGuard guard(used_, used_->shared_);
+  if (!other.prev_) {
+    return;
+  }
+  next_ = other.next_;
+  prev_ = other.prev_;
+  relink(this);
+  other.next_ = nullptr;
+  other.prev_ = nullptr;
+}
+
+/*!
+ *@brief use的移动赋值
+ */
+Use &Use::operator=(Use &&other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  unlink();
+  val_ = other.val_;
+  arg_no_ = other.arg_no_;
+  used_ = other.used_;
+  if (used_) {
+    UseListGuard guard(used_, used_->shared_);
+    if (!other.prev_) {
+      return *this;
+    }
+    next_ = other.next_;
+    prev_ = other.prev_;
+    relink(this);
+    other.next_ = nullptr;
+    other.prev_ = nullptr;
+  }
+  return *this;
+}
+
+/*!
+ *@brief 改为使用新的value
+ *@param v 新的value，可为nullptr
+ */
+void Use::set(Value *v) {
+  unlink();
+  used_ = v;
+  if (v) {
+    v->add_use(this);
+  }
+}
+
+/*!
+ *@brief 从use链摘除，保留used_
+ */
+void Use::unlink() {
+  if (used_) {
+    used_->remove_use(this);
+  }
+}
+
+/*!
+ *@brief 使用者个数
+ */
+size_t UseList::size() const {
+  size_t n = 0;
+  for (Use *u = head_; u; u = u->next_) {
+    n++;
+  }
+  return n;
+}
 
 /*!
  *@brief 添加use
- *@param val 使用该value的value
- *@param arg_no 在指令中的顺序
+ *@param use 使用者操作数数组中的use节点
+ *@note
+ *---------
+ *挂到use链头部
+ */
+void Value::add_use(Use *use) {
+  UseListGuard guard(this, shared_);
+  use->next_ = use_head_;
+  if (use_head_) {
+    use_head_->prev_ = &use->next_;
+  }
+  use->prev_ = &use_head_;
+  use_head_ = use;
+}
+/*!
+ *@brief 对于value设置名称
+ *@param name value名称
+ *@return 名称设置的布尔结果
  *@note
  *---------
- *在use链中添加
+ *名称字符串驻留在所属模块中，同名的value共享一份；空名称不占空间
  */
-void Value::add_use(Value *val, unsigned arg_no) {
-  use_list_.push_back(Use(val, arg_no));
+bool Value::set_name(const std::string &name) {
+  if (name_) {
+    return false;
+  }
+  if (!name.empty()) {
+    name_ = type_->get_module()->intern_name(name);
+  }
+  return true;
 }
+
 /*!
  *@brief 获取value的名称
- *@return value字符串常量
+ *@return value名称，未命名时为空串
  */
-std::string Value::get_name() const { return name_; }
+const std::string &Value::get_name() const {
+  static const std::string empty;
+  return name_ ? *name_ : empty;
+}
 /*!
  *@brief 替换所有对于旧value的引用，改为新的
  *@param new_val value型指针
  *@note
  *--------
  *支持对于所有的value的修改，包括基本块
- *&emsp; 首先遍历所属的use_list，修改其他value中对于当前value的引用为新value
- *&emsp; 转换value类型为basicblock，修改成功即为对基本块间的类型调用修改，
- *&emsp; 依次修改前置后置的链表中对于该基本块的引用
+ *&emsp; 每次取use链首节点改挂到新value上，直到链为空，每个use O(1)
+ *&emsp; 替换基本块时，使用者为已登记出边的跳转指令的，
+ *&emsp; 把这条入边从旧块的前驱表移到新块的前驱表
  */
 void Value::replace_all_use_with(Value *new_val) {
-  for (auto use : use_list_) {
-    auto val = dynamic_cast<User *>(use.val_);
-    assert(val && "new_val is not a user");
-    val->set_operand(use.arg_no_, new_val);
-  }
-  auto val = dynamic_cast<BasicBlock *>(this);
-  if (val) {
-    auto new_bb = dynamic_cast<BasicBlock *>(new_val);
-    for (BasicBlock *pre_bb : val->get_pre_basic_blocks()) {
-      pre_bb->remove_succ_basic_block(val);
-      pre_bb->add_succ_basic_block(new_bb);
-      new_bb->add_pre_basic_block(pre_bb);
-    }
-    for (BasicBlock *suc_bb : val->get_succ_basic_blocks()) {
-      suc_bb->remove_pre_basic_block(val);
-      suc_bb->add_pre_basic_block(new_bb);
-      new_bb->add_succ_basic_block(suc_bb);
+  if (new_val == this) {
+    return;
+  }
+  auto old_bb = dynamic_cast<BasicBlock *>(this);
+  while (use_head_) {
+    assert(dynamic_cast<User *>(use_head_->val_) && "new_val is not a user");
+    if (old_bb) {
+      auto br = dynamic_cast<BranchInst *>(use_head_->val_);
+      if (br && br->is_linked()) {
+        old_bb->remove_pre_basic_block(br->get_parent());
+        static_cast<BasicBlock *>(new_val)->add_pre_basic_block(
+            br->get_parent());
+      }
     }
+    use_head_->set(new_val);
   }
 }
 
 /*!
- *@brief 替换所有对于旧value的引用，改为新的
- *@param val value型指针
+ *@brief 从本value的use链摘除指定use
+ *@param use 以本value为used_的use节点，已摘除时不做任何事
  *@note
  *----------
- *设置lambda函数，判定val的匹配
- *匹配成功则进行value的相关删除
+ *通过prev_直接改写前一节点的next_，无需遍历
  */
-void Value::remove_use(Value *val) {
-  auto is_val = [val](const Use &use) { return use.val_ == val; };
-  use_list_.remove_if(is_val);
-}
\ No newline at end of file
+void Value::remove_use(Use *use) {
+  UseListGuard guard(this, shared_);
+  if (!use->prev_) {
+    return; // 已摘除
+  }
+  *use->prev_ = use->next_;
+  if (use->next_) {
+    use->next_->prev_ = use->prev_;
+  }
+  use->next_ = nullptr;
+  use->prev_ = nullptr;
+}
@@ -1,6 +1,18 @@
 #include "AST.h"
 #include "../codegen/IRGenerator.h"
 
+// 释放整棵 AST：子节点先入栈再删除父节点，栈深与树高无关
+void ASTNode::destroyTree(ASTNode* root) {
+    std::vector<ASTNode*> work;
+    if (root) work.push_back(root);
+    while (!work.empty()) {
+        ASTNode* node = work.back();
+        work.pop_back();
+        node->collectChildren(work);
+        delete node;
+    }
+}
+
 // 编译单元
 Value* CompUnit::accept(IRGenerator& gen) { 
     return gen.visit(this); 
@@ -41,6 +53,11 @@ Value* BinaryExp::accept(IRGenerator& gen) {
     return gen.visit(this); 
 }
 
+// 单目表达式
+Value* UnaryExp::accept(IRGenerator& gen) { 
+    return gen.visit(this); 
+}
+
 // 函数调用（新增 - 修复 LNK2001 错误的关键）
 Value* CallExp::accept(IRGenerator& gen) { 
     return gen.visit(this); 
@@ -13,6 +13,12 @@ public:
     // 核心接口：Visitor 模式，用于接受 IRGenerator 访问并生成中间代码
     // 返回值 Value* 对应后端的 IR 值（如指令、常量、变量地址等）
     virtual Value* accept(IRGenerator& gen) = 0;
+
+    // 将直接子节点追加到 out 中（空指针跳过），供显式栈遍历使用
+    virtual void collectChildren(std::vector<ASTNode*>& out) {}
+
+    // 使用显式工作栈释放整棵树，避免超长表达式链递归析构爆栈
+    static void destroyTree(ASTNode* root);
 };
 
 // 表达式基类 (Expression)
@@ -28,6 +34,9 @@ public:
     std::vector<ASTNode*> children; 
 
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        for (auto c : children) if (c) out.push_back(c);
+    }
 };
 
 // 函数形式参数定义 (例如: int a)
@@ -35,9 +44,10 @@ class FuncFParam : public ASTNode {
 public:
     std::string type; // "int" 等
     std::string name; // 参数名
+    int id;           // 参数名在符号表中的 ID
 
-    FuncFParam(const std::string& t, const std::string& n) 
-        : type(t), name(n) {}
+    FuncFParam(const std::string& t, const std::string& n, int i = -1) 
+        : type(t), name(n), id(i) {}
     
     Value* accept(IRGenerator& gen) override;
 };
@@ -51,6 +61,9 @@ public:
     BlockStmt(const std::vector<ASTNode*>& s) : stmts(s) {}
     
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        for (auto s : stmts) if (s) out.push_back(s);
+    }
 };
 
 // 函数定义: int main() { ... }
@@ -66,6 +79,10 @@ public:
         : type(t), name(n), params(p), body(b) {}
         
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        for (auto p : params) if (p) out.push_back(p);
+        if (body) out.push_back(body);
+    }
 };
 
 // 变量定义: int a = 10;
@@ -73,12 +90,17 @@ class VarDefStmt : public Stmt {
 public:
     std::string type;
     std::string name;
+    int id;       // 变量名在符号表中的 ID
     Exp* initVal; // 初始值表达式，如果没有初始化则为 nullptr
+    bool isConst; // 来自 constDecl
 
-    VarDefStmt(const std::string& t, const std::string& n, Exp* i) 
-        : type(t), name(n), initVal(i) {}
+    VarDefStmt(const std::string& t, const std::string& n, Exp* i, int symId = -1) 
+        : type(t), name(n), id(symId), initVal(i), isConst(false) {}
         
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        if (initVal) out.push_back(initVal);
+    }
 };
 
 // If 语句: if (cond) thenStmt else elseStmt
@@ -92,6 +114,11 @@ public:
         : cond(c), thenStmt(t), elseStmt(e) {}
         
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        if (cond) out.push_back(cond);
+        if (thenStmt) out.push_back(thenStmt);
+        if (elseStmt) out.push_back(elseStmt);
+    }
 };
 
 // Return 语句: return exp;
@@ -102,6 +129,9 @@ public:
     ReturnStmt(Exp* v) : retValue(v) {}
     
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        if (retValue) out.push_back(retValue);
+    }
 };
 
 // 二元表达式: a + b, a > b 等
@@ -115,6 +145,25 @@ public:
         : op(o), lhs(l), rhs(r) {}
         
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        if (lhs) out.push_back(lhs);
+        if (rhs) out.push_back(rhs);
+    }
+};
+
+// 单目表达式: !a（负号仍由 Parser 改写为 0 - E）
+class UnaryExp : public Exp {
+public:
+    std::string op; // 目前只有 "!"
+    Exp* operand;
+
+    UnaryExp(const std::string& o, Exp* e) 
+        : op(o), operand(e) {}
+        
+    Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        if (operand) out.push_back(operand);
+    }
 };
 
 // 函数调用表达式: add(a, b)
@@ -127,6 +176,9 @@ public:
         : funcName(n), args(a) {}
         
     Value* accept(IRGenerator& gen) override;
+    void collectChildren(std::vector<ASTNode*>& out) override {
+        for (auto a : args) if (a) out.push_back(a);
+    }
 };
 
 // 数字常量: 123
@@ -146,8 +198,9 @@ public:
 class IdExp : public Exp {
 public:
     std::string name;
+    int id; // 词法分析时驻留的符号表 ID，运算符等非标识符为 -1
 
-    IdExp(const std::string& n) : name(n) {}
+    IdExp(const std::string& n, int i = -1) : name(n), id(i) {}
     
     Value* accept(IRGenerator& gen) override;
 };
\ No newline at end of file
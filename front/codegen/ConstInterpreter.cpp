@@ -0,0 +1,475 @@
+#include "ConstInterpreter.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+// 常量二元运算，语义与 evaluateConst 原有实现一致
+ConstVal foldConstBinary(const std::string& op, ConstVal l, ConstVal r) {
+    bool resIsFloat = l.isFloat || r.isFloat;
+    float lf = l.isFloat ? l.f : (float)l.i;
+    float rf = r.isFloat ? r.f : (float)r.i;
+    int li = l.isFloat ? (int)l.f : l.i;
+    int ri = r.isFloat ? (int)r.f : r.i;
+
+    // 逻辑运算 (&&, ||) 永远返回 int (0或1)
+    if (op == "&&" || op == "OP_AND") {
+        int val = (l.isFloat ? lf != 0 : li != 0) && (r.isFloat ? rf != 0 : ri != 0);
+        return {false, val, 0.0f};
+    }
+    if (op == "||" || op == "OP_OR") {
+        int val = (l.isFloat ? lf != 0 : li != 0) || (r.isFloat ? rf != 0 : ri != 0);
+        return {false, val, 0.0f};
+    }
+
+    if (resIsFloat) {
+        if (op == "+" || op == "OP_PLUS") return {true, 0, lf + rf};
+        if (op == "-" || op == "OP_MINUS") return {true, 0, lf - rf};
+        if (op == "*" || op == "OP_MUL") return {true, 0, lf * rf};
+        if (op == "/" || op == "OP_DIV") return {true, 0, (rf != 0 ? lf / rf : 0)};
+        // 比较运算
+        if (op == ">" || op == "OP_GT") return {false, lf > rf, 0.0f};
+        if (op == "<" || op == "OP_LT") return {false, lf < rf, 0.0f};
+        if (op == ">=" || op == "OP_GE") return {false, lf >= rf, 0.0f};
+        if (op == "<=" || op == "OP_LE") return {false, lf <= rf, 0.0f};
+        if (op == "==" || op == "OP_EQ") return {false, lf == rf, 0.0f};
+        if (op == "!=" || op == "OP_NEQ") return {false, lf != rf, 0.0f};
+    } 
+    else {
+        if (op == "+" || op == "OP_PLUS") return {false, li + ri, 0.0f};
+        if (op == "-" || op == "OP_MINUS") return {false, li - ri, 0.0f};
+        if (op == "*" || op == "OP_MUL") return {false, li * ri, 0.0f};
+        if (op == "/" || op == "OP_DIV") return {false, (ri != 0 ? li / ri : 0), 0.0f};
+        if (op == "%" || op == "OP_MOD") return {false, (ri != 0 ? li % ri : 0), 0.0f};
+        // 比较运算
+        if (op == ">" || op == "OP_GT") return {false, li > ri, 0.0f};
+        if (op == "<" || op == "OP_LT") return {false, li < ri, 0.0f};
+        if (op == ">=" || op == "OP_GE") return {false, li >= ri, 0.0f};
+        if (op == "<=" || op == "OP_LE") return {false, li <= ri, 0.0f};
+        if (op == "==" || op == "OP_EQ") return {false, li == ri, 0.0f};
+        if (op == "!=" || op == "OP_NEQ") return {false, li != ri, 0.0f};
+    }
+    return {false, 0, 0.0f};
+}
+
+// ========== ConstInterpreter 实现 ==========
+
+bool convertConst(ConstVal v, bool toFloat, ConstVal& out) {
+    if (toFloat) {
+        out = v.isFloat ? v : ConstVal{true, 0, (float)v.i};
+        return true;
+    }
+    if (!v.isFloat) {
+        out = v;
+        return true;
+    }
+    if (!(v.f >= -2147483648.0f && v.f < 2147483648.0f)) return false;
+    out = {false, (int)v.f, 0.0f};
+    return true;
+}
+
+// 与 IRGenerator::emitBinaryOp 及常量折叠一致：有 float 操作数时两边都转为 float
+bool evalConstBinary(const std::string& op, ConstVal l, ConstVal r, ConstVal& out) {
+    if (l.isFloat || r.isFloat) {
+        float a = l.isFloat ? l.f : (float)l.i;
+        float b = r.isFloat ? r.f : (float)r.i;
+        if (op == "+" || op == "OP_PLUS") { out = {true, 0, a + b}; return true; }
+        if (op == "-" || op == "OP_MINUS") { out = {true, 0, a - b}; return true; }
+        if (op == "*" || op == "OP_MUL") { out = {true, 0, a * b}; return true; }
+        if (op == "/" || op == "OP_DIV") { out = {true, 0, a / b}; return true; }
+        int c;
+        if (op == "<" || op == "OP_LT") c = a < b;
+        else if (op == ">" || op == "OP_GT") c = a > b;
+        else if (op == "<=" || op == "OP_LE") c = a <= b;
+        else if (op == ">=" || op == "OP_GE") c = a >= b;
+        else if (op == "==" || op == "OP_EQ") c = a == b;
+        else if (op == "!=" || op == "OP_NEQ") c = a != b;
+        else c = 0; // 浮点 % 在生成代码时得到常量 0
+        out = {false, c, 0.0f};
+        return true;
+    }
+
+    int a = l.i, b = r.i;
+    uint32_t ua = (uint32_t)a, ub = (uint32_t)b;
+    int res;
+    if (op == "+" || op == "OP_PLUS") res = (int)(ua + ub);
+    else if (op == "-" || op == "OP_MINUS") res = (int)(ua - ub);
+    else if (op == "*" || op == "OP_MUL") res = (int)(ua * ub);
+    else if (op == "/" || op == "OP_DIV" || op == "%" || op == "OP_MOD") {
+        if (b == 0 || (a == INT_MIN && b == -1)) return false;
+        res = (op == "/" || op == "OP_DIV") ? a / b : a % b;
+    }
+    else if (op == "<" || op == "OP_LT") res = a < b;
+    else if (op == ">" || op == "OP_GT") res = a > b;
+    else if (op == "<=" || op == "OP_LE") res = a <= b;
+    else if (op == ">=" || op == "OP_GE") res = a >= b;
+    else if (op == "==" || op == "OP_EQ") res = a == b;
+    else if (op == "!=" || op == "OP_NEQ") res = a != b;
+    else return false;
+    out = {false, res, 0.0f};
+    return true;
+}
+
+
+namespace {
+
+bool isAssignOp(const std::string& op) { return op == "=" || op == "OP_ASSIGN"; }
+bool isAndOp(const std::string& op) { return op == "&&" || op == "OP_AND"; }
+bool isOrOp(const std::string& op) { return op == "||" || op == "OP_OR"; }
+
+bool truthy(ConstVal v) { return v.isFloat ? v.f != 0 : v.i != 0; }
+
+uint64_t encode(ConstVal v) {
+    uint32_t bits;
+    if (v.isFloat) std::memcpy(&bits, &v.f, sizeof(bits));
+    else bits = (uint32_t)v.i;
+    return ((uint64_t)v.isFloat << 32) | bits;
+}
+
+} // namespace
+
+ConstInterpreter::ConstInterpreter(CompUnit* unit, const std::map<std::string, ConstVal>& globals,
+                                   long fuel, int maxDepth, long budget)
+    : fuelLimit(fuel), depthLimit(maxDepth), budgetLimit(budget) {
+    for (auto child : unit->children) {
+        if (auto fd = dynamic_cast<FuncDef*>(child)) addFunction(fd);
+    }
+    finish(globals);
+}
+
+ConstInterpreter::ConstInterpreter(long fuel, int maxDepth, long budget)
+    : fuelLimit(fuel), depthLimit(maxDepth), budgetLimit(budget) {}
+
+// 纯函数分析：
+//   1. addFunction 扫描每个函数体，收集局部声明、被赋值的名字、被引用的名字与被调用的函数
+//   2. finish 中任一函数中被赋值的全局同名量视为可变，其余全局量按初值当常量读取
+//   3. 赋值或读取非局部的可变名字、调用未定义函数的为非纯函数，再沿调用关系传播到不动点
+// 局部与全局同名时按保守方向处理，执行期的动态检查兜底
+bool ConstInterpreter::addFunction(FuncDef* fd) {
+    if (funcs.count(fd->name)) return false; // 同名函数以先定义者为准
+    FuncInfo& info = funcs[fd->name];
+    info = {fd, true};
+
+    Summary sum;
+    for (auto p : fd->params) sum.declared.insert(p->name);
+    std::vector<ASTNode*> work;
+    if (fd->body) work.push_back(fd->body);
+    while (!work.empty()) {
+        ASTNode* n = work.back();
+        work.pop_back();
+        if (auto v = dynamic_cast<VarDefStmt*>(n)) sum.declared.insert(v->name);
+        else if (auto id = dynamic_cast<IdExp*>(n)) sum.referenced.insert(id->name);
+        else if (auto call = dynamic_cast<CallExp*>(n)) sum.called.insert(call->funcName);
+        else if (auto bin = dynamic_cast<BinaryExp*>(n)) {
+            if (isAssignOp(bin->op)) {
+                if (auto id = dynamic_cast<IdExp*>(bin->lhs)) sum.assigned.insert(id->name);
+            }
+        }
+        n->collectChildren(work);
+    }
+    // 赋值非局部名字的函数无论全局量如何都不是纯函数
+    for (auto& name : sum.assigned) {
+        if (!sum.declared.count(name)) info.pure = false;
+    }
+    summaries.push_back({fd->name, std::move(sum)});
+    return info.pure;
+}
+
+void ConstInterpreter::finish(const std::map<std::string, ConstVal>& globals) {
+    std::unordered_set<std::string> written;
+    for (auto& d : summaries) {
+        for (auto& name : d.second.assigned) {
+            if (globals.count(name)) written.insert(name);
+        }
+    }
+    for (auto& g : globals) {
+        if (!written.count(g.first)) constGlobals[g.first] = g.second;
+    }
+
+    for (auto& d : summaries) {
+        FuncInfo& info = funcs[d.first];
+        const Summary& sum = d.second;
+        for (auto& name : sum.referenced) {
+            if (!sum.declared.count(name) && !constGlobals.count(name)) info.pure = false;
+        }
+        for (auto& name : sum.called) {
+            if (!funcs.count(name)) info.pure = false;
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& d : summaries) {
+            FuncInfo& info = funcs[d.first];
+            if (!info.pure) continue;
+            for (auto& name : d.second.called) {
+                auto it = funcs.find(name);
+                if (it == funcs.end() || !it->second.pure) {
+                    info.pure = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    std::vector<std::pair<std::string, Summary>>().swap(summaries);
+}
+
+bool ConstInterpreter::isPure(const std::string& func) const {
+    auto it = funcs.find(func);
+    return it != funcs.end() && it->second.pure;
+}
+
+// 单次调用的燃料取上限与会话剩余预算中的较小者，用掉的从预算中扣除；
+// 预算用完后会话中的调用都直接放弃，一个函数的编译期求值总量因此有界
+bool ConstInterpreter::call(Session& session, const std::string& func,
+                            const std::vector<ConstVal>& args, ConstVal& result) const {
+    auto it = funcs.find(func);
+    if (it == funcs.end() || !it->second.pure || session.budget <= 0) return false;
+    Context ctx;
+    ctx.fuel = std::min(fuelLimit, session.budget);
+    ctx.depth = 0;
+    ctx.failure = Failure::None;
+    ctx.session = &session;
+    long start = ctx.fuel;
+    bool ok = invoke(it->second.def, args, result, ctx);
+    session.budget -= start - std::max(ctx.fuel, 0L);
+    if (!ok) return false;
+    // 结果要落成 IR 常量，非有限值不折叠
+    if (result.isFloat && !std::isfinite(result.f)) return false;
+    return true;
+}
+
+ConstInterpreter::Local* ConstInterpreter::lookup(const std::string& name, Context& ctx) const {
+    for (auto it = ctx.scopes.rbegin(); it != ctx.scopes.rend(); ++it) {
+        auto found = it->find(name);
+        if (found != it->end()) return &found->second;
+    }
+    return nullptr;
+}
+
+// 会话中的记录：
+//   - 成功的结果按 (函数, 实参) 记忆，纯函数的结果与调用次序无关
+//   - 耗尽燃料时，展开路径上的每个函数都记为耗尽，此后对它们的调用不论实参直接放弃
+//   - 其余失败（未定义行为等）按 (函数, 实参) 记住；超出深度的失败取决于调用位置，不记录
+bool ConstInterpreter::invoke(FuncDef* def, const std::vector<ConstVal>& args, ConstVal& result, Context& ctx) const {
+    Session& session = *ctx.session;
+    if (session.exhausted.count(def)) {
+        ctx.failure = Failure::Fuel;
+        return false;
+    }
+    if (args.size() != def->params.size()) return false;
+    if (ctx.depth >= depthLimit) {
+        ctx.failure = Failure::Depth;
+        return false;
+    }
+
+    std::vector<uint64_t> key;
+    key.push_back((uint64_t)(uintptr_t)def);
+    std::vector<ConstVal> params;
+    for (size_t i = 0; i < args.size(); i++) {
+        ConstVal v;
+        if (!convertConst(args[i], def->params[i]->type == "float", v)) return false;
+        params.push_back(v);
+        key.push_back(encode(v));
+    }
+    auto memo = session.memo.find(key);
+    if (memo != session.memo.end()) {
+        result = memo->second;
+        return true;
+    }
+    if (session.failed.count(key)) return false;
+
+    // 被调函数看不到调用者的局部变量
+    std::vector<std::unordered_map<std::string, Local>> saved;
+    saved.swap(ctx.scopes);
+    ctx.scopes.emplace_back();
+    for (size_t i = 0; i < params.size(); i++) {
+        ctx.scopes.back()[def->params[i]->name] = {params[i], params[i].isFloat, true};
+    }
+
+    ctx.depth++;
+    ConstVal ret = {def->type == "float", 0, 0.0f};
+    Flow flow = exec(def->body, def, ret, ctx);
+    ctx.depth--;
+    ctx.scopes.swap(saved);
+
+    bool ok = flow != Flow::Fail;
+    if (ok && (def->type == "float" || def->type == "int")) {
+        ok = convertConst(ret, def->type == "float", ret);
+    } else if (ok) {
+        ret = {false, 0, 0.0f};
+    }
+    if (!ok) {
+        if (ctx.failure == Failure::Fuel) session.exhausted.insert(def);
+        else if (ctx.failure == Failure::None) session.failed.insert(key);
+        return false;
+    }
+    session.memo[key] = ret;
+    result = ret;
+    return true;
+}
+
+ConstInterpreter::Flow ConstInterpreter::exec(ASTNode* stmt, FuncDef* def, ConstVal& ret, Context& ctx) const {
+    if (!stmt) return Flow::Normal;
+    if (--ctx.fuel < 0) {
+        ctx.failure = Failure::Fuel;
+        return Flow::Fail;
+    }
+
+    if (auto block = dynamic_cast<BlockStmt*>(stmt)) {
+        ctx.scopes.emplace_back();
+        for (auto s : block->stmts) {
+            Flow flow = exec(s, def, ret, ctx);
+            if (flow != Flow::Normal) {
+                ctx.scopes.pop_back();
+                return flow;
+            }
+        }
+        ctx.scopes.pop_back();
+        return Flow::Normal;
+    }
+    if (auto list = dynamic_cast<CompUnit*>(stmt)) {
+        // 一条声明语句中的多个变量定义
+        for (auto c : list->children) {
+            Flow flow = exec(c, def, ret, ctx);
+            if (flow != Flow::Normal) return flow;
+        }
+        return Flow::Normal;
+    }
+    if (auto var = dynamic_cast<VarDefStmt*>(stmt)) {
+        bool isFloat = var->type == "float";
+        Local local = {{isFloat, 0, 0.0f}, isFloat, false};
+        if (var->initVal) {
+            ConstVal v;
+            if (!eval(var->initVal, v, ctx) || !convertConst(v, isFloat, local.val)) return Flow::Fail;
+            local.init = true;
+        }
+        ctx.scopes.back()[var->name] = local;
+        return Flow::Normal;
+    }
+    if (auto ifs = dynamic_cast<IfStmt*>(stmt)) {
+        ConstVal c;
+        if (!eval(ifs->cond, c, ctx)) return Flow::Fail;
+        return exec(truthy(c) ? (ASTNode*)ifs->thenStmt : (ASTNode*)ifs->elseStmt, def, ret, ctx);
+    }
+    if (auto rs = dynamic_cast<ReturnStmt*>(stmt)) {
+        if (rs->retValue && !eval(rs->retValue, ret, ctx)) return Flow::Fail;
+        return Flow::Return;
+    }
+    if (auto exp = dynamic_cast<Exp*>(stmt)) {
+        ConstVal ignored;
+        return eval(exp, ignored, ctx) ? Flow::Normal : Flow::Fail;
+    }
+    return Flow::Fail;
+}
+
+// 表达式求值：显式栈，stage 记录节点已完成的子步骤，&& / || 保持短路
+bool ConstInterpreter::eval(Exp* exp, ConstVal& out, Context& ctx) const {
+    struct Frame { Exp* exp; int stage; };
+    std::vector<Frame> work;
+    std::vector<ConstVal> values;
+    work.push_back({exp, 0});
+
+    while (!work.empty()) {
+        Frame fr = work.back();
+        work.pop_back();
+        if (--ctx.fuel < 0) {
+            ctx.failure = Failure::Fuel;
+            return false;
+        }
+
+        if (auto num = dynamic_cast<NumberExp*>(fr.exp)) {
+            if (num->isFloat) values.push_back({true, 0, num->floatVal});
+            else values.push_back({false, num->intVal, 0.0f});
+        }
+        else if (auto id = dynamic_cast<IdExp*>(fr.exp)) {
+            if (Local* local = lookup(id->name, ctx)) {
+                if (!local->init) return false; // 读未初始化变量
+                values.push_back(local->val);
+            } else {
+                auto g = constGlobals.find(id->name);
+                if (g == constGlobals.end()) return false;
+                values.push_back(g->second);
+            }
+        }
+        else if (auto un = dynamic_cast<UnaryExp*>(fr.exp)) {
+            if (fr.stage == 0) {
+                work.push_back({un, 1});
+                work.push_back({un->operand, 0});
+            } else {
+                ConstVal v = values.back(); values.pop_back();
+                values.push_back({false, !truthy(v), 0.0f});
+            }
+        }
+        else if (auto bin = dynamic_cast<BinaryExp*>(fr.exp)) {
+            if (isAssignOp(bin->op)) {
+                if (fr.stage == 0) {
+                    work.push_back({bin, 1});
+                    work.push_back({bin->rhs, 0});
+                    continue;
+                }
+                auto id = dynamic_cast<IdExp*>(bin->lhs);
+                Local* local = id ? lookup(id->name, ctx) : nullptr;
+                if (!local) return false; // 写全局量即有副作用
+                ConstVal v = values.back(); values.pop_back();
+                if (!convertConst(v, local->isFloat, local->val)) return false;
+                local->init = true;
+                values.push_back(local->val);
+            }
+            else if (isAndOp(bin->op) || isOrOp(bin->op)) {
+                bool isAnd = isAndOp(bin->op);
+                if (fr.stage == 0) {
+                    work.push_back({bin, 1});
+                    work.push_back({bin->lhs, 0});
+                } else if (fr.stage == 1) {
+                    bool l = truthy(values.back()); values.pop_back();
+                    if (l != isAnd) {
+                        values.push_back({false, l ? 1 : 0, 0.0f});
+                    } else {
+                        work.push_back({bin, 2});
+                        work.push_back({bin->rhs, 0});
+                    }
+                } else {
+                    bool r = truthy(values.back()); values.pop_back();
+                    values.push_back({false, r ? 1 : 0, 0.0f});
+                }
+            }
+            else {
+                if (fr.stage == 0) {
+                    work.push_back({bin, 1});
+                    work.push_back({bin->rhs, 0});
+                    work.push_back({bin->lhs, 0});
+                    continue;
+                }
+                ConstVal r = values.back(); values.pop_back();
+                ConstVal l = values.back(); values.pop_back();
+                ConstVal res;
+                if (!evalConstBinary(bin->op, l, r, res)) return false;
+                values.push_back(res);
+            }
+        }
+        else if (auto call = dynamic_cast<CallExp*>(fr.exp)) {
+            if (fr.stage == 0) {
+                work.push_back({call, 1});
+                for (auto it = call->args.rbegin(); it != call->args.rend(); ++it) {
+                    work.push_back({*it, 0});
+                }
+                continue;
+            }
+            auto it = funcs.find(call->funcName);
+            if (it == funcs.end() || !it->second.pure) return false;
+            std::vector<ConstVal> args(values.end() - call->args.size(), values.end());
+            values.resize(values.size() - call->args.size());
+            ConstVal res;
+            if (!invoke(it->second.def, args, res, ctx)) return false;
+            values.push_back(res);
+        }
+        else {
+            return false;
+        }
+    }
+    out = values.back();
+    return true;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "../ast/AST.h"
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 编译期常量值，供 evaluateConst 与 ConstInterpreter 使用
+struct ConstVal {
+    bool isFloat;
+    int i;
+    float f;
+};
+
+// 常量二元运算（全局初始化表达式使用的语义：除零得 0）
+ConstVal foldConstBinary(const std::string& op, ConstVal l, ConstVal r);
+
+// 运行期语义的常量二元运算（不含 &&、||、=）：与生成的代码一致，
+// i32 按补码回绕；除零、INT_MIN / -1 等运行期未定义的情况返回 false
+bool evalConstBinary(const std::string& op, ConstVal l, ConstVal r, ConstVal& out);
+
+// 按目标类型转换常量，与 IRGenerator::typeCast 一致；fptosi 越界时返回 false
+bool convertConst(ConstVal v, bool toFloat, ConstVal& out);
+
+// 编译期解释器：在 AST 上以常量实参执行无副作用的函数
+//   - 预先做一次纯函数分析：写全局量、读会被写的全局量、调用未定义或非纯函数的都不是纯函数
+//   - 执行时仍动态检查，遇到未初始化读、除零、越界转换等运行期才有定义的情况即放弃
+//   - 每次调用有燃料（执行步数）与调用深度上限；燃料同时从所属会话的总预算中扣除
+//   - 会话跨调用保存记忆表与失败记录：同参数的调用只求值一次，
+//     因未定义行为失败的按函数与实参记住，耗尽燃料的按函数记住，之后直接放弃
+// 解释器本身只读，可被多个生成线程共享；会话由调用者持有，一个函数的生成过程一个会话，
+// 各函数的折叠结果因此与线程调度无关
+class ConstInterpreter {
+public:
+    // globals：全局量名字 -> 初值（已按声明类型转换），其中被任何函数赋值过的不会被读取
+    ConstInterpreter(CompUnit* unit, const std::map<std::string, ConstVal>& globals,
+                     long fuel = 1000000, int maxDepth = 1000, long budget = 4000000);
+    // 逐个加入函数定义，全部加入后调用 finish；用于逐个函数编译，不需要整棵 AST
+    explicit ConstInterpreter(long fuel = 1000000, int maxDepth = 1000, long budget = 4000000);
+
+    // 一组相继调用共享的状态：剩余燃料预算、记忆表与失败记录
+    class Session {
+    public:
+        explicit Session(const ConstInterpreter& interp) : budget(interp.budgetLimit) {}
+    private:
+        friend class ConstInterpreter;
+        long budget;
+        std::map<std::vector<uint64_t>, ConstVal> memo;
+        std::set<std::vector<uint64_t>> failed;    // 因未定义行为等失败的 (函数, 实参)
+        std::unordered_set<FuncDef*> exhausted;    // 求值时耗尽燃料的函数
+    };
+
+    // 加入一个函数定义并收集摘要；返回 false 表示已能断定它不会被执行
+    // （与先前的函数同名，或赋值了非局部的名字），调用者可释放其函数体
+    bool addFunction(FuncDef* fd);
+    // 按全局量初值完成纯函数分析，此后 isPure 为 false 的函数体可释放
+    void finish(const std::map<std::string, ConstVal>& globals);
+
+    // 静态分析认定为纯函数
+    bool isPure(const std::string& func) const;
+
+    // 以常量实参调用函数，成功时写入 result；非纯、超出燃料或遇到未定义行为返回 false
+    bool call(Session& session, const std::string& func, const std::vector<ConstVal>& args,
+              ConstVal& result) const;
+
+private:
+    struct FuncInfo {
+        FuncDef* def;
+        bool pure;
+    };
+    std::unordered_map<std::string, FuncInfo> funcs;
+    std::unordered_map<std::string, ConstVal> constGlobals; // 从未被赋值的全局量
+    long fuelLimit;   // 单次调用的燃料
+    int depthLimit;
+    long budgetLimit; // 一个会话的燃料总预算
+
+    // 单次求值的执行状态
+    struct Local {
+        ConstVal val;
+        bool isFloat;
+        bool init;
+    };
+    // 失败原因：只有与调用深度无关的失败才记入会话
+    enum class Failure { None, Fuel, Depth };
+    struct Context {
+        long fuel;
+        int depth;
+        Failure failure;
+        std::vector<std::unordered_map<std::string, Local>> scopes;
+        Session* session;
+    };
+    enum class Flow { Normal, Return, Fail };
+
+    // 函数体中声明、赋值、引用的名字与调用的函数，finish 后释放
+    struct Summary {
+        std::unordered_set<std::string> declared, assigned, referenced, called;
+    };
+    std::vector<std::pair<std::string, Summary>> summaries;
+
+    bool invoke(FuncDef* def, const std::vector<ConstVal>& args, ConstVal& result, Context& ctx) const;
+    Flow exec(ASTNode* stmt, FuncDef* def, ConstVal& ret, Context& ctx) const;
+    bool eval(Exp* exp, ConstVal& out, Context& ctx) const;
+    Local* lookup(const std::string& name, Context& ctx) const;
+};
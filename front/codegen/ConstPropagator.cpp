@@ -0,0 +1,178 @@
+#include "ConstPropagator.h"
+
+void ConstPropagator::run(CompUnit* root) {
+    if (!root) return;
+    for (auto child : root->children) visitTopLevel(child);
+}
+
+void ConstPropagator::visitTopLevel(ASTNode* item) {
+    if (auto list = dynamic_cast<CompUnit*>(item)) {
+        for (auto c : list->children) {
+            if (auto def = dynamic_cast<VarDefStmt*>(c)) visitVarDef(def, true);
+        }
+    } else if (auto def = dynamic_cast<VarDefStmt*>(item)) {
+        visitVarDef(def, true);
+    } else if (auto fd = dynamic_cast<FuncDef*>(item)) {
+        table.enterScope();
+        for (auto p : fd->params) table.put(p->name, Binding{false, {false, 0, 0.0f}});
+        if (fd->body) visitStmt(fd->body);
+        table.exitScope();
+    }
+}
+
+bool ConstPropagator::visitVarDef(VarDefStmt* def, bool global) {
+    if (def->initVal) substitute(def->initVal);
+
+    ConstVal val;
+    bool folded = def->isConst && def->initVal && evaluate(def->initVal, val) &&
+                  convertConst(val, def->type == "float", val);
+    table.put(def->name, Binding{folded, val});
+    if (!folded) return true;
+
+    if (global) {
+        // 全局 const 仍生成全局量，初值直接给出折叠结果
+        ASTNode::destroyTree(def->initVal);
+        def->initVal = val.isFloat ? new NumberExp(val.f) : new NumberExp(val.i);
+        return true;
+    }
+    return false;
+}
+
+ASTNode* ConstPropagator::visitStmt(ASTNode* stmt) {
+    if (!stmt) return nullptr;
+
+    if (auto block = dynamic_cast<BlockStmt*>(stmt)) {
+        table.enterScope();
+        std::vector<ASTNode*> kept;
+        for (auto s : block->stmts) {
+            if (auto r = visitStmt(s)) kept.push_back(r);
+        }
+        block->stmts.swap(kept);
+        table.exitScope();
+        return block;
+    }
+    if (auto list = dynamic_cast<CompUnit*>(stmt)) {
+        // 局部声明语句：删去已被替换的 const 定义
+        std::vector<ASTNode*> kept;
+        for (auto c : list->children) {
+            auto def = dynamic_cast<VarDefStmt*>(c);
+            if (def && !visitVarDef(def, false)) ASTNode::destroyTree(def);
+            else kept.push_back(c);
+        }
+        list->children.swap(kept);
+        if (list->children.empty()) {
+            delete list;
+            return nullptr;
+        }
+        return list;
+    }
+    if (auto def = dynamic_cast<VarDefStmt*>(stmt)) {
+        if (visitVarDef(def, false)) return def;
+        ASTNode::destroyTree(def);
+        return nullptr;
+    }
+    if (auto ifs = dynamic_cast<IfStmt*>(stmt)) {
+        substitute(ifs->cond);
+        ConstVal c;
+        if (ifs->cond && evaluate(ifs->cond, c)) {
+            // 条件为常量：取出会执行的分支，其余部分连同条件一起释放
+            bool taken = c.isFloat ? c.f != 0 : c.i != 0;
+            Stmt* keep = taken ? ifs->thenStmt : ifs->elseStmt;
+            if (taken) ifs->thenStmt = nullptr;
+            else ifs->elseStmt = nullptr;
+            ASTNode::destroyTree(ifs);
+            return visitStmt(keep);
+        }
+        ifs->thenStmt = static_cast<Stmt*>(visitStmt(ifs->thenStmt));
+        ifs->elseStmt = static_cast<Stmt*>(visitStmt(ifs->elseStmt));
+        return ifs;
+    }
+    if (auto rs = dynamic_cast<ReturnStmt*>(stmt)) {
+        if (rs->retValue) substitute(rs->retValue);
+        return rs;
+    }
+    if (auto exp = dynamic_cast<Exp*>(stmt)) {
+        Exp* e = exp;
+        substitute(e);
+        return e;
+    }
+    return stmt;
+}
+
+// 显式栈遍历表达式树，逐个检查子表达式槽位
+void ConstPropagator::substitute(Exp*& slot) {
+    std::vector<Exp**> work;
+    work.push_back(&slot);
+    while (!work.empty()) {
+        Exp** cur = work.back();
+        work.pop_back();
+        Exp* e = *cur;
+        if (!e) continue;
+
+        if (auto id = dynamic_cast<IdExp*>(e)) {
+            Binding b = table.get(id->name);
+            if (b.isConst) {
+                *cur = b.val.isFloat ? new NumberExp(b.val.f) : new NumberExp(b.val.i);
+                delete id;
+            }
+        } else if (auto bin = dynamic_cast<BinaryExp*>(e)) {
+            // 赋值的左值保持为名字
+            if (bin->op != "=" && bin->op != "OP_ASSIGN") work.push_back(&bin->lhs);
+            work.push_back(&bin->rhs);
+        } else if (auto un = dynamic_cast<UnaryExp*>(e)) {
+            work.push_back(&un->operand);
+        } else if (auto call = dynamic_cast<CallExp*>(e)) {
+            for (auto& a : call->args) work.push_back(&a);
+        }
+    }
+}
+
+// 后序求值，&& / || 两侧都是字面量，无需短路也不会有副作用
+bool ConstPropagator::evaluate(Exp* exp, ConstVal& out) {
+    struct Frame { Exp* exp; bool expanded; };
+    std::vector<Frame> work;
+    std::vector<ConstVal> values;
+    work.push_back({exp, false});
+
+    while (!work.empty()) {
+        Frame fr = work.back();
+        work.pop_back();
+
+        if (auto num = dynamic_cast<NumberExp*>(fr.exp)) {
+            if (num->isFloat) values.push_back({true, 0, num->floatVal});
+            else values.push_back({false, num->intVal, 0.0f});
+        } else if (auto un = dynamic_cast<UnaryExp*>(fr.exp)) {
+            if (!fr.expanded) {
+                work.push_back({un, true});
+                work.push_back({un->operand, false});
+                continue;
+            }
+            ConstVal v = values.back(); values.pop_back();
+            values.push_back({false, v.isFloat ? v.f == 0 : v.i == 0, 0.0f});
+        } else if (auto bin = dynamic_cast<BinaryExp*>(fr.exp)) {
+            if (bin->op == "=" || bin->op == "OP_ASSIGN") return false;
+            if (!fr.expanded) {
+                work.push_back({bin, true});
+                work.push_back({bin->rhs, false});
+                work.push_back({bin->lhs, false});
+                continue;
+            }
+            ConstVal r = values.back(); values.pop_back();
+            ConstVal l = values.back(); values.pop_back();
+            ConstVal res;
+            bool isAnd = bin->op == "&&" || bin->op == "OP_AND";
+            if (isAnd || bin->op == "||" || bin->op == "OP_OR") {
+                bool lt = l.isFloat ? l.f != 0 : l.i != 0;
+                bool rt = r.isFloat ? r.f != 0 : r.i != 0;
+                res = {false, isAnd ? (lt && rt) : (lt || rt), 0.0f};
+            } else if (!evalConstBinary(bin->op, l, r, res)) {
+                return false;
+            }
+            values.push_back(res);
+        } else {
+            return false;
+        }
+    }
+    out = values.back();
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../ast/AST.h"
+#include "../common/SymbolTable.h"
+#include "ConstInterpreter.h"
+
+// AST 上的常量传播，在 IRGenerator 之前运行：
+//   - const 声明的初值能按运行期语义求出时，名字绑定到该常量，作用域内的引用替换为 NumberExp
+//   - 已绑定的局部 const 声明从 AST 中删去，不再生成 alloca/store/load；全局 const 保留并标记为常量
+//   - if 条件求值为常量时，只保留会执行的分支
+class ConstPropagator {
+public:
+    void run(CompUnit* root);
+    // 按源码顺序处理一个顶层项（全局声明或函数定义），run 即依次调用本函数
+    void visitTopLevel(ASTNode* item);
+
+private:
+    // 名字当前绑定到的常量；isConst 为 false 表示普通变量（会遮蔽外层 const）
+    struct Binding {
+        bool isConst;
+        ConstVal val;
+    };
+    ScopedTable<Binding> table;
+
+    // 处理一条语句，返回替换后的节点；返回 nullptr 表示该语句被删去
+    ASTNode* visitStmt(ASTNode* stmt);
+    // 处理声明，返回 false 表示这个局部 const 已被完全替换，可删去
+    bool visitVarDef(VarDefStmt* def, bool global);
+    // 替换表达式中对 const 的引用，slot 为父节点中指向该表达式的指针
+    void substitute(Exp*& slot);
+    // 仅由字面量构成的表达式按运行期语义求值
+    bool evaluate(Exp* exp, ConstVal& out);
+};
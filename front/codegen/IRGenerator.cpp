@@ -3,45 +3,25 @@
 #include "compiler_ir/include/BasicBlock.h"
 #include "compiler_ir/include/Function.h"
 #include "compiler_ir/include/GlobalVariable.h"
+#include "compiler_ir/include/StackColoring.h"
 #include "compiler_ir/include/Type.h"
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <map>
 
-// ========== 辅助类：作用域管理 ==========
-class ScopeManager {
-public:
-    std::vector<std::map<std::string, Value*>> scopes;
-    
-    ScopeManager() { enter(); }
-    void enter() { scopes.emplace_back(); }
-    void exit() { if (!scopes.empty()) scopes.pop_back(); }
-    bool declare(const std::string& name, Value* val) {
-        if (scopes.empty()) return false;
-        if (scopes.back().find(name) != scopes.back().end()) return false;
-        scopes.back()[name] = val;
-        return true;
-    }
-    Value* lookup(const std::string& name) {
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
-            if (it->find(name) != it->end()) return it->at(name);
-        }
-        return nullptr;
-    }
-    bool isGlobal() const { return scopes.size() == 1; }
-};
-
-static ScopeManager scopeMgr;
-
-// 全局常量表
-static std::map<std::string, ConstVal> globalConstValues;
-
 // ========== IRGenerator 实现 ==========
 
-IRGenerator::IRGenerator(Module* m, SymbolTable* st) : module(m), currentFunc(nullptr) {
-    builder = new IRBuilder(nullptr, module);
-    scopeMgr = ScopeManager(); // 重置作用域
-    globalConstValues.clear(); // 清空全局常量表
+IRGenerator::IRGenerator(Module* m, SymbolTable* st, int jobs)
+    : module(m), currentFunc(nullptr), symTable(st), jobs(jobs), reachableOnly(false),
+      ssa(false), ssaBuilder(nullptr) {
+    builder = new FoldingIRBuilder(nullptr, module);
+}
+
+IRGenerator::~IRGenerator() {
+    delete builder;
 }
 
 Value* IRGenerator::typeCast(Value* val, Type* targetType) {
@@ -74,81 +54,166 @@ Value* IRGenerator::typeCast(Value* val, Type* targetType) {
 }
 
 // 【修改】全面增强 evaluateConst，支持所有操作符，解决全局变量初始化问题
+// 使用显式工作栈做后序求值，超长的 a + b + c + ... 链不会递归爆栈
 ConstVal IRGenerator::evaluateConst(ASTNode* node) {
-    if (auto num = dynamic_cast<NumberExp*>(node)) {
-        if (num->isFloat) return {true, 0, num->floatVal};
-        return {false, num->intVal, 0.0f};
-    }
-    else if (auto id = dynamic_cast<IdExp*>(node)) {
-        if (globalConstValues.count(id->name)) {
-            return globalConstValues[id->name];
+    struct Frame { ASTNode* node; bool expanded; };
+    std::vector<Frame> work;
+    std::vector<ConstVal> values;
+    work.push_back({node, false});
+
+    while (!work.empty()) {
+        Frame fr = work.back();
+        work.pop_back();
+
+        auto bin = dynamic_cast<BinaryExp*>(fr.node);
+        auto un = dynamic_cast<UnaryExp*>(fr.node);
+        if (fr.expanded) {
+            if (un) {
+                // 逻辑非: !E 与 E == 0 同义
+                ConstVal v = values.back(); values.pop_back();
+                values.push_back({false, v.isFloat ? v.f == 0 : v.i == 0, 0.0f});
+                continue;
+            }
+            ConstVal r = values.back(); values.pop_back();
+            ConstVal l = values.back(); values.pop_back();
+            values.push_back(foldConstBinary(bin->op, l, r));
+            continue;
         }
-        std::cerr << "Error: Global initializer refers to unknown or non-const variable: " << id->name << std::endl;
-        return {false, 0, 0.0f};
-    }
-    else if (auto bin = dynamic_cast<BinaryExp*>(node)) {
-        ConstVal l = evaluateConst(bin->lhs);
-        ConstVal r = evaluateConst(bin->rhs);
-        
-        bool resIsFloat = l.isFloat || r.isFloat;
-        float lf = l.isFloat ? l.f : (float)l.i;
-        float rf = r.isFloat ? r.f : (float)r.i;
-        int li = l.isFloat ? (int)l.f : l.i;
-        int ri = r.isFloat ? (int)r.f : r.i;
-        
-        std::string op = bin->op;
-        
-        // 逻辑运算 (&&, ||) 永远返回 int (0或1)
-        if (op == "&&" || op == "OP_AND") {
-            int val = (l.isFloat ? lf != 0 : li != 0) && (r.isFloat ? rf != 0 : ri != 0);
-            return {false, val, 0.0f};
+        if (un) {
+            work.push_back({un, true});
+            work.push_back({un->operand, false});
+            continue;
         }
-        if (op == "||" || op == "OP_OR") {
-            int val = (l.isFloat ? lf != 0 : li != 0) || (r.isFloat ? rf != 0 : ri != 0);
-            return {false, val, 0.0f};
+        if (bin) {
+            // 先压右再压左，保证左操作数先出栈求值
+            work.push_back({bin, true});
+            work.push_back({bin->rhs, false});
+            work.push_back({bin->lhs, false});
+            continue;
         }
 
-        if (resIsFloat) {
-            if (op == "+" || op == "OP_PLUS") return {true, 0, lf + rf};
-            if (op == "-" || op == "OP_MINUS") return {true, 0, lf - rf};
-            if (op == "*" || op == "OP_MUL") return {true, 0, lf * rf};
-            if (op == "/" || op == "OP_DIV") return {true, 0, (rf != 0 ? lf / rf : 0)};
-            // 比较运算
-            if (op == ">" || op == "OP_GT") return {false, lf > rf, 0.0f};
-            if (op == "<" || op == "OP_LT") return {false, lf < rf, 0.0f};
-            if (op == ">=" || op == "OP_GE") return {false, lf >= rf, 0.0f};
-            if (op == "<=" || op == "OP_LE") return {false, lf <= rf, 0.0f};
-            if (op == "==" || op == "OP_EQ") return {false, lf == rf, 0.0f};
-            if (op == "!=" || op == "OP_NEQ") return {false, lf != rf, 0.0f};
-        } 
+        if (auto num = dynamic_cast<NumberExp*>(fr.node)) {
+            if (num->isFloat) values.push_back({true, 0, num->floatVal});
+            else values.push_back({false, num->intVal, 0.0f});
+        }
+        else if (auto id = dynamic_cast<IdExp*>(fr.node)) {
+            if (globalConstValues.count(id->name)) {
+                values.push_back(globalConstValues[id->name]);
+            } else {
+                std::cerr << "Error: Global initializer refers to unknown or non-const variable: " << id->name << std::endl;
+                values.push_back({false, 0, 0.0f});
+            }
+        }
         else {
-            if (op == "+" || op == "OP_PLUS") return {false, li + ri, 0.0f};
-            if (op == "-" || op == "OP_MINUS") return {false, li - ri, 0.0f};
-            if (op == "*" || op == "OP_MUL") return {false, li * ri, 0.0f};
-            if (op == "/" || op == "OP_DIV") return {false, (ri != 0 ? li / ri : 0), 0.0f};
-            if (op == "%" || op == "OP_MOD") return {false, (ri != 0 ? li % ri : 0), 0.0f};
-            // 比较运算
-            if (op == ">" || op == "OP_GT") return {false, li > ri, 0.0f};
-            if (op == "<" || op == "OP_LT") return {false, li < ri, 0.0f};
-            if (op == ">=" || op == "OP_GE") return {false, li >= ri, 0.0f};
-            if (op == "<=" || op == "OP_LE") return {false, li <= ri, 0.0f};
-            if (op == "==" || op == "OP_EQ") return {false, li == ri, 0.0f};
-            if (op == "!=" || op == "OP_NEQ") return {false, li != ri, 0.0f};
+            values.push_back({false, 0, 0.0f});
         }
     }
-    return {false, 0, 0.0f};
+    return values.back();
 }
 
 Value* ASTNode::accept(IRGenerator& gen) { return nullptr; }
 
-Value* IRGenerator::visit(CompUnit* node) {
+std::set<std::string> IRGenerator::reachableFunctions(const std::vector<FuncDef*>& defs) {
+    std::map<std::string, FuncDef*> byName;
+    for (auto fd : defs) byName[fd->name] = fd;
+
+    std::set<std::string> reached;
+    std::vector<FuncDef*> pending;
+    auto mark = [&](const std::string& name) {
+        auto it = byName.find(name);
+        if (it != byName.end() && reached.insert(name).second) pending.push_back(it->second);
+    };
+    mark("main");
+    for (auto& name : exports) mark(name);
+
+    // 调用图的边在遍历函数体时按需展开，只访问可达函数的 AST
+    std::vector<ASTNode*> work;
+    while (!pending.empty()) {
+        FuncDef* fd = pending.back();
+        pending.pop_back();
+        if (fd->body) work.push_back(fd->body);
+        while (!work.empty()) {
+            ASTNode* n = work.back();
+            work.pop_back();
+            if (auto call = dynamic_cast<CallExp*>(n)) mark(call->funcName);
+            n->collectChildren(work);
+        }
+    }
+    return reached;
+}
+
+// 编译单元分两步生成：
+//   1. 顺序处理全局变量，并声明全部函数签名（函数按源码顺序进入模块）
+//   2. 生成函数体；jobs > 1 时由线程池按下标领取，每个线程持有独立的
+//      IRGenerator 与符号表副本，模块中只有类型表、名称索引和共享值的 use list 需要加锁
+std::vector<std::pair<FuncDef*, Function*>> IRGenerator::declareTopLevel(CompUnit* node) {
+    std::set<std::string> reached;
+    if (reachableOnly) {
+        std::vector<FuncDef*> defs;
+        for (auto child : node->children) {
+            if (auto fd = dynamic_cast<FuncDef*>(child)) defs.push_back(fd);
+        }
+        reached = reachableFunctions(defs);
+    }
+
+    std::vector<std::pair<FuncDef*, Function*>> funcs;
     for (auto child : node->children) {
-        if (child) child->accept(*this);
+        if (!child) continue;
+        if (auto fd = dynamic_cast<FuncDef*>(child)) {
+            // 不可达的函数既不声明也不生成，可达函数不会引用它们
+            if (reachableOnly && !reached.count(fd->name)) continue;
+            funcs.push_back({fd, declareFunction(fd)});
+        } else {
+            child->accept(*this);
+        }
     }
+    return funcs;
+}
+
+Value* IRGenerator::visit(CompUnit* node) {
+    auto funcs = declareTopLevel(node);
+    // 只含变量定义的 CompUnit 是一条声明语句，到此为止
+    if (funcs.empty()) return nullptr;
+
+    // 全局初值已知，纯函数调用可在编译期求值
+    interp = std::make_shared<const ConstInterpreter>(node, globalConstValues);
+
+    int workers = jobs;
+    if (workers > (int)funcs.size()) workers = (int)funcs.size();
+    if (workers <= 1) {
+        for (auto& fn : funcs) defineFunction(fn.first, fn.second);
+        return nullptr;
+    }
+
+    std::atomic<size_t> next{0};
+    std::vector<std::unique_ptr<SymbolTable>> tables;
+    std::vector<std::unique_ptr<IRGenerator>> gens;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < workers; t++) {
+        tables.emplace_back(new SymbolTable(*symTable));
+        gens.emplace_back(new IRGenerator(module, tables.back().get()));
+        gens.back()->globalConstValues = globalConstValues;
+        gens.back()->interp = interp;
+        gens.back()->ssa = ssa;
+    }
+    for (int t = 0; t < workers; t++) {
+        IRGenerator* gen = gens[t].get();
+        threads.emplace_back([&funcs, &next, gen]() {
+            for (size_t i = next++; i < funcs.size(); i = next++) {
+                gen->defineFunction(funcs[i].first, funcs[i].second);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
     return nullptr;
 }
 
 Value* IRGenerator::visit(FuncDef* node) {
+    defineFunction(node, declareFunction(node));
+    return nullptr;
+}
+
+Function* IRGenerator::declareFunction(FuncDef* node) {
     std::vector<Type*> paramTypes;
     for (auto p : node->params) {
         if (p->type == "float") paramTypes.push_back(Type::get_float_type(module));
@@ -160,13 +225,35 @@ Value* IRGenerator::visit(FuncDef* node) {
     else if (node->type == "float") retType = Type::get_float_type(module);
     
     FunctionType* ft = FunctionType::get(retType, paramTypes);
-    Function* f = Function::create(ft, node->name, module);
+    return Function::create(ft, node->name, module);
+}
+
+void IRGenerator::defineFunction(FuncDef* node, Function* f) {
+    Type* retType = f->get_function_type()->get_return_type();
     currentFunc = f;
     
     BasicBlock* entry = BasicBlock::create(module, "entry", f);
     builder->set_insert_point(entry);
 
-    scopeMgr.enter();
+    // 每个函数体一个会话，折叠结果只取决于本函数中调用的先后，与线程调度无关
+    if (interp) interpSession.reset(new ConstInterpreter::Session(*interp));
+
+    // 无参纯函数（如不读输入的 main）整体在编译期求值，函数体只剩一条 ret
+    ConstVal folded;
+    if (interp && node->params.empty() && !retType->is_void_type() &&
+        interp->call(*interpSession, node->name, {}, folded)) {
+        if (folded.isFloat) builder->create_ret(ConstantFloat::get(folded.f, module));
+        else builder->create_ret(ConstantInt::get(folded.i, module));
+        interpSession.reset();
+        currentFunc = nullptr;
+        return;
+    }
+
+    if (ssa) {
+        ssaBuilder = new SSABuilder(module);
+        ssaBuilder->seal_block(entry);
+    }
+    symTable->enterScope();
 
     auto args = f->get_args();
     int idx = 0;
@@ -175,9 +262,7 @@ Value* IRGenerator::visit(FuncDef* node) {
         FuncFParam* p = node->params[idx];
         Type* argType = arg->get_type();
         
-        Value* alloc = builder->create_alloca(argType);
-        builder->create_store(arg, alloc);
-        scopeMgr.declare(p->name, alloc);
+        writeVariable(declareLocal(p->id, argType), arg);
         idx++;
     }
 
@@ -189,20 +274,30 @@ Value* IRGenerator::visit(FuncDef* node) {
         else builder->create_ret(ConstantInt::get(0, module));
     }
     
-    scopeMgr.exit();
+    symTable->exitScope();
+
+    if (ssa) {
+        delete ssaBuilder;
+        ssaBuilder = nullptr;
+        for (auto var : ssaVars) delete var;
+        ssaVars.clear();
+    } else {
+        // 局部变量已全部放在入口块，合并生命周期不重叠的栈槽
+        StackColoring(f).run();
+    }
+    interpSession.reset();
     currentFunc = nullptr;
-    return nullptr;
 }
 
 Value* IRGenerator::visit(BlockStmt* node) {
-    scopeMgr.enter();
+    symTable->enterScope();
     for (auto stmt : node->stmts) {
         if (builder->get_insert_block()->get_terminator()) {
             break; 
         }
         if (stmt) stmt->accept(*this);
     }
-    scopeMgr.exit();
+    symTable->exitScope();
     return nullptr;
 }
 
@@ -213,7 +308,7 @@ Value* IRGenerator::visit(VarDefStmt* node) {
     else 
         varType = Type::get_int32_type(module);
 
-    if (scopeMgr.isGlobal()) {
+    if (symTable->isGlobal()) {
         Constant* initConst = nullptr;
         ConstVal val = {false, 0, 0.0f};
 
@@ -233,46 +328,39 @@ Value* IRGenerator::visit(VarDefStmt* node) {
             globalConstValues[node->name] = {varType->is_float_type(), 0, 0.0f};
         }
 
-        GlobalVariable* gVar = GlobalVariable::create(node->name, module, varType, false, initConst);
-        scopeMgr.declare(node->name, gVar);
+        GlobalVariable* gVar = GlobalVariable::create(node->name, module, varType, node->isConst, initConst);
+        symTable->put(node->id, gVar);
 
     } else {
-        Value* alloc = builder->create_alloca(varType);
-        scopeMgr.declare(node->name, alloc);
+        Value* var = declareLocal(node->id, varType);
         
         if (node->initVal) {
             Value* v = node->initVal->accept(*this);
             v = typeCast(v, varType);
-            builder->create_store(v, alloc);
+            writeVariable(var, v);
         }
     }
     return nullptr;
 }
 
 Value* IRGenerator::visit(IfStmt* node) {
-    Value* cond = node->cond->accept(*this);
-    cond = typeCast(cond, Type::get_int1_type(module));
-
-    Function* f = currentFunc;
-    BasicBlock* trueBB = BasicBlock::create(module, "if_true", f);
-    BasicBlock* falseBB = BasicBlock::create(module, "if_false", f);
-    BasicBlock* nextBB = BasicBlock::create(module, "if_next", f);
-    
-    BasicBlock* falseTarget = node->elseStmt ? falseBB : nextBB;
+    BasicBlock* trueBB = newBlock("if_true");
+    BasicBlock* falseBB = node->elseStmt ? newBlock("if_false") : nullptr;
+    BasicBlock* nextBB = newBlock("if_next");
 
-    builder->create_cond_br(cond, trueBB, falseTarget);
+    genCond(node->cond, trueBB, falseBB ? falseBB : nextBB);
 
-    builder->set_insert_point(trueBB);
+    enterBlock(trueBB);
     if (node->thenStmt) node->thenStmt->accept(*this);
     if (!builder->get_insert_block()->get_terminator()) builder->create_br(nextBB);
 
     if (node->elseStmt) {
-        builder->set_insert_point(falseBB);
+        enterBlock(falseBB);
         node->elseStmt->accept(*this);
         if (!builder->get_insert_block()->get_terminator()) builder->create_br(nextBB);
     }
     
-    builder->set_insert_point(nextBB); 
+    enterBlock(nextBB); 
     return nullptr;
 }
 
@@ -295,63 +383,63 @@ Value* IRGenerator::visit(BinaryExp* node) {
 
     if (op == "=" || op == "OP_ASSIGN") {
         auto id = dynamic_cast<IdExp*>(node->lhs);
-        Value* ptr = scopeMgr.lookup(id->name);
+        Value* ptr = symTable->get(id->id);
         if (ptr) {
             Value* v = node->rhs->accept(*this);
             Type* targetType = ptr->get_type()->get_pointer_element_type();
             v = typeCast(v, targetType);
-            builder->create_store(v, ptr);
+            writeVariable(ptr, v);
             return v;
         }
         return ConstantInt::get(0, module);
     }
     
-    if (op == "&&" || op == "OP_AND") {
-        Value* l = node->lhs->accept(*this);
-        l = typeCast(l, Type::get_int1_type(module));
-
-        BasicBlock* rhsBB = BasicBlock::create(module, "and_rhs", currentFunc);
-        BasicBlock* endBB = BasicBlock::create(module, "and_end", currentFunc);
-        
-        Value* resVar = builder->create_alloca(Type::get_int32_type(module));
-        builder->create_store(ConstantInt::get(0, module), resVar); 
-        
-        builder->create_cond_br(l, rhsBB, endBB);
-        
-        builder->set_insert_point(rhsBB);
-        Value* r = node->rhs->accept(*this);
-        r = typeCast(r, Type::get_int1_type(module)); 
-        builder->create_store(builder->create_zext(r, Type::get_int32_type(module)), resVar);
-        builder->create_br(endBB);
-        
-        builder->set_insert_point(endBB);
-        return builder->create_load(resVar);
+    if (op == "&&" || op == "OP_AND" || op == "||" || op == "OP_OR") {
+        return builder->create_zext(genLogicValue(node), Type::get_int32_type(module));
     }
-    if (op == "||" || op == "OP_OR") {
-        Value* l = node->lhs->accept(*this);
-        l = typeCast(l, Type::get_int1_type(module));
 
-        BasicBlock* rhsBB = BasicBlock::create(module, "or_rhs", currentFunc);
-        BasicBlock* endBB = BasicBlock::create(module, "or_end", currentFunc);
-        
-        Value* resVar = builder->create_alloca(Type::get_int32_type(module));
-        builder->create_store(ConstantInt::get(1, module), resVar); 
-        
-        builder->create_cond_br(l, endBB, rhsBB);
-        
-        builder->set_insert_point(rhsBB);
-        Value* r = node->rhs->accept(*this);
-        r = typeCast(r, Type::get_int1_type(module));
-        builder->create_store(builder->create_zext(r, Type::get_int32_type(module)), resVar);
-        builder->create_br(endBB);
-        
-        builder->set_insert_point(endBB);
-        return builder->create_load(resVar);
+    // 算术/关系运算：显式栈后序遍历，长表达式链的栈深保持为常数
+    // 赋值与短路运算带有控制流，仍交给 accept 处理
+    auto isPlain = [](Exp* e) -> BinaryExp* {
+        auto bin = dynamic_cast<BinaryExp*>(e);
+        if (!bin) return nullptr;
+        const std::string& o = bin->op;
+        if (o == "=" || o == "OP_ASSIGN" || o == "&&" || o == "OP_AND" || o == "||" || o == "OP_OR")
+            return nullptr;
+        return bin;
+    };
+
+    struct Frame { Exp* exp; bool expanded; };
+    std::vector<Frame> work;
+    std::vector<Value*> values;
+    work.push_back({node, false});
+
+    while (!work.empty()) {
+        Frame fr = work.back();
+        work.pop_back();
+
+        if (fr.expanded) {
+            Value* r = values.back(); values.pop_back();
+            Value* l = values.back(); values.pop_back();
+            values.push_back(emitBinaryOp(static_cast<BinaryExp*>(fr.exp)->op, l, r));
+            continue;
+        }
+        if (auto bin = isPlain(fr.exp)) {
+            work.push_back({bin, true});
+            work.push_back({bin->rhs, false});
+            work.push_back({bin->lhs, false});
+            continue;
+        }
+        values.push_back(fr.exp->accept(*this));
     }
+    return values.back();
+}
 
-    Value* l = node->lhs->accept(*this);
-    Value* r = node->rhs->accept(*this);
-    
+Value* IRGenerator::visit(UnaryExp* node) {
+    return builder->create_zext(genBool(node), Type::get_int32_type(module));
+}
+
+Value* IRGenerator::emitBinaryOp(const std::string& op, Value* l, Value* r) {
     bool isFloatOp = l->get_type()->is_float_type() || r->get_type()->is_float_type();
     
     if (isFloatOp) {
@@ -364,42 +452,205 @@ Value* IRGenerator::visit(BinaryExp* node) {
         if (op == "-" || op == "OP_MINUS") return builder->create_fsub(l, r);
         if (op == "*" || op == "OP_MUL") return builder->create_fmul(l, r);
         if (op == "/" || op == "OP_DIV") return builder->create_fdiv(l, r);
-        
-        Value* cmp = nullptr;
-        if (op == "<"  || op == "OP_LT") cmp = builder->create_fcmp_lt(l, r);
-        if (op == ">"  || op == "OP_GT") cmp = builder->create_fcmp_gt(l, r);
-        if (op == "==" || op == "OP_EQ") cmp = builder->create_fcmp_eq(l, r);
-        if (op == "!=" || op == "OP_NEQ") cmp = builder->create_fcmp_ne(l, r);
-        if (op == "<=" || op == "OP_LE") cmp = builder->create_fcmp_le(l, r);
-        if (op == ">=" || op == "OP_GE") cmp = builder->create_fcmp_ge(l, r);
-        
-        if (cmp) return builder->create_zext(cmp, Type::get_int32_type(module));
     } else {
         if (op == "+" || op == "OP_PLUS") return builder->create_iadd(l, r);
         if (op == "-" || op == "OP_MINUS") return builder->create_isub(l, r);
         if (op == "*" || op == "OP_MUL") return builder->create_imul(l, r);
         if (op == "/" || op == "OP_DIV") return builder->create_isdiv(l, r);
         if (op == "%" || op == "OP_MOD") return builder->create_irem(l, r);
-        
-        Value* cmp = nullptr;
-        if (op == "<"  || op == "OP_LT") cmp = builder->create_icmp_lt(l, r);
-        if (op == ">"  || op == "OP_GT") cmp = builder->create_icmp_gt(l, r);
-        if (op == "==" || op == "OP_EQ") cmp = builder->create_icmp_eq(l, r);
-        if (op == "!=" || op == "OP_NEQ") cmp = builder->create_icmp_ne(l, r);
-        if (op == "<=" || op == "OP_LE") cmp = builder->create_icmp_le(l, r);
-        if (op == ">=" || op == "OP_GE") cmp = builder->create_icmp_ge(l, r);
-        
-        if (cmp) return builder->create_zext(cmp, Type::get_int32_type(module));
     }
+
+    if (Value* cmp = emitCompare(op, l, r))
+        return builder->create_zext(cmp, Type::get_int32_type(module));
     
     return ConstantInt::get(0, module);
 }
 
-Value* IRGenerator::visit(CallExp* node) {
-    Function* f = nullptr;
-    for (auto func : module->get_functions()) {
-        if (func->get_name() == node->funcName) { f = func; break; }
+Value* IRGenerator::emitCompare(const std::string& op, Value* l, Value* r) {
+    bool isFloatOp = l->get_type()->is_float_type() || r->get_type()->is_float_type();
+
+    if (isFloatOp) {
+        l = typeCast(l, Type::get_float_type(module));
+        r = typeCast(r, Type::get_float_type(module));
+
+        if (op == "<"  || op == "OP_LT") return builder->create_fcmp_lt(l, r);
+        if (op == ">"  || op == "OP_GT") return builder->create_fcmp_gt(l, r);
+        if (op == "==" || op == "OP_EQ") return builder->create_fcmp_eq(l, r);
+        if (op == "!=" || op == "OP_NEQ") return builder->create_fcmp_ne(l, r);
+        if (op == "<=" || op == "OP_LE") return builder->create_fcmp_le(l, r);
+        if (op == ">=" || op == "OP_GE") return builder->create_fcmp_ge(l, r);
+    } else {
+        if (op == "<"  || op == "OP_LT") return builder->create_icmp_lt(l, r);
+        if (op == ">"  || op == "OP_GT") return builder->create_icmp_gt(l, r);
+        if (op == "==" || op == "OP_EQ") return builder->create_icmp_eq(l, r);
+        if (op == "!=" || op == "OP_NEQ") return builder->create_icmp_ne(l, r);
+        if (op == "<=" || op == "OP_LE") return builder->create_icmp_le(l, r);
+        if (op == ">=" || op == "OP_GE") return builder->create_icmp_ge(l, r);
+    }
+    return nullptr;
+}
+
+static bool isLogicOp(const std::string& op, bool& isAnd) {
+    isAnd = (op == "&&" || op == "OP_AND");
+    return isAnd || op == "||" || op == "OP_OR";
+}
+
+BasicBlock* IRGenerator::newBlock(const std::string& name) {
+    return BasicBlock::create(module, name, nullptr);
+}
+
+void IRGenerator::enterBlock(BasicBlock* bb) {
+    bb->insert_into(currentFunc);
+    builder->set_insert_point(bb);
+    if (ssa) ssaBuilder->seal_block(bb);
+}
+
+Value* IRGenerator::declareLocal(int id, Type* ty) {
+    Value* var = nullptr;
+    if (ssa) {
+        // 与 alloca 同为指针类型，赋值处按指针元素类型转换的逻辑不变
+        ssaVars.push_back(new (module) Value(PointerType::get(ty)));
+        var = ssaVars.back();
+    } else {
+        var = builder->create_entry_alloca(ty);
+    }
+    symTable->put(id, var);
+    return var;
+}
+
+Value* IRGenerator::readVariable(Value* var) {
+    if (ssa && !dynamic_cast<GlobalVariable*>(var)) {
+        Type* ty = var->get_type()->get_pointer_element_type();
+        return ssaBuilder->read_variable(var, ty, builder->get_insert_block());
+    }
+    return builder->create_load(var);
+}
+
+void IRGenerator::writeVariable(Value* var, Value* val) {
+    if (ssa && !dynamic_cast<GlobalVariable*>(var)) {
+        ssaBuilder->write_variable(var, builder->get_insert_block(), val);
+        return;
+    }
+    builder->create_store(val, var);
+}
+
+// 条件跳转生成：
+//   !E        交换真假出口
+//   A && B    A 为假直接跳 falseBB，否则进入 and_rhs 再判断 B
+//   A || B    A 为真直接跳 trueBB，否则进入 or_rhs 再判断 B
+//   常量      直接无条件跳转（含被折叠成常量的条件）
+// 用工作栈处理，左深的长 && / || 链不会递归；enter 非空时先进入该块再生成
+void IRGenerator::genCond(Exp* exp, BasicBlock* trueBB, BasicBlock* falseBB) {
+    struct Item { Exp* exp; BasicBlock* t; BasicBlock* f; BasicBlock* enter; };
+    std::vector<Item> work;
+    work.push_back({exp, trueBB, falseBB, nullptr});
+
+    while (!work.empty()) {
+        Item it = work.back();
+        work.pop_back();
+        if (it.enter) enterBlock(it.enter);
+
+        Exp* e = it.exp;
+        while (auto un = dynamic_cast<UnaryExp*>(e)) {
+            std::swap(it.t, it.f);
+            e = un->operand;
+        }
+
+        bool isAnd = false;
+        auto bin = dynamic_cast<BinaryExp*>(e);
+        if (bin && isLogicOp(bin->op, isAnd)) {
+            BasicBlock* mid = newBlock(isAnd ? "and_rhs" : "or_rhs");
+            // 右操作数后处理，先入栈
+            work.push_back({bin->rhs, it.t, it.f, mid});
+            if (isAnd) work.push_back({bin->lhs, mid, it.f, nullptr});
+            else work.push_back({bin->lhs, it.t, mid, nullptr});
+            continue;
+        }
+
+        if (auto num = dynamic_cast<NumberExp*>(e)) {
+            bool nonzero = num->isFloat ? num->floatVal != 0 : num->intVal != 0;
+            builder->create_br(nonzero ? it.t : it.f);
+            continue;
+        }
+
+        Value* cond = genBool(e);
+        if (auto c = dynamic_cast<ConstantInt*>(cond)) {
+            // 条件已折叠为常量
+            builder->create_br(c->get_value() ? it.t : it.f);
+            continue;
+        }
+        builder->create_cond_br(cond, it.t, it.f);
+    }
+}
+
+Value* IRGenerator::genBool(Exp* exp) {
+    Type* int1Type = Type::get_int1_type(module);
+
+    bool negate = false;
+    while (auto un = dynamic_cast<UnaryExp*>(exp)) {
+        negate = !negate;
+        exp = un->operand;
+    }
+
+    Value* v = nullptr;
+    bool isAnd = false;
+    auto bin = dynamic_cast<BinaryExp*>(exp);
+    if (bin && isLogicOp(bin->op, isAnd)) {
+        v = genLogicValue(bin);
+    } else if (bin && bin->op != "=" && bin->op != "OP_ASSIGN") {
+        // 比较运算直接得到 i1，省去 zext 再与 0 比较
+        Value* l = bin->lhs->accept(*this);
+        Value* r = bin->rhs->accept(*this);
+        v = emitCompare(bin->op, l, r);
+        if (!v) v = typeCast(emitBinaryOp(bin->op, l, r), int1Type);
+    } else {
+        v = exp->accept(*this);
+        // !E 对非布尔值直接与 0 比较
+        if (negate && !v->get_type()->is_int1_type()) {
+            if (v->get_type()->is_float_type())
+                return builder->create_fcmp_eq(v, ConstantFloat::get(0.0f, module));
+            return builder->create_icmp_eq(v, ConstantInt::get(0, module));
+        }
+        v = typeCast(v, int1Type);
     }
+
+    if (negate) v = builder->create_icmp_eq(v, ConstantInt::get(false, module));
+    return v;
+}
+
+Value* IRGenerator::genLogicValue(BinaryExp* node) {
+    bool isAnd = false;
+    isLogicOp(node->op, isAnd);
+
+    BasicBlock* rhsBB = newBlock(isAnd ? "and_rhs" : "or_rhs");
+    BasicBlock* endBB = newBlock(isAnd ? "and_end" : "or_end");
+
+    if (isAnd) genCond(node->lhs, rhsBB, endBB);
+    else genCond(node->lhs, endBB, rhsBB);
+
+    enterBlock(rhsBB);
+    Value* r = genBool(node->rhs);
+    BasicBlock* rhsEnd = builder->get_insert_block();
+    builder->create_br(endBB);
+
+    // 除 rhs 出口外，其余前驱都是被短路跳过来的：&& 取 false，|| 取 true
+    enterBlock(endBB);
+    auto& preds = endBB->get_pre_basic_blocks();
+    if (preds.size() == 1 && preds.front() == rhsEnd) {
+        // 左操作数已折叠为常量，不存在短路路径
+        return r;
+    }
+    PhiInst* phi = PhiInst::create_phi(Type::get_int1_type(module), endBB);
+    endBB->add_instr_begin(phi);
+    for (auto pred : preds) {
+        Value* incoming = (pred == rhsEnd) ? r : ConstantInt::get(!isAnd, module);
+        phi->add_phi_pair_operand(incoming, pred);
+    }
+    return phi;
+}
+
+Value* IRGenerator::visit(CallExp* node) {
+    Function* f = module->get_function(node->funcName);
     if (!f) {
         std::cerr << "Error: Function not found: " << node->funcName << std::endl;
         return ConstantInt::get(0, module); 
@@ -417,13 +668,28 @@ Value* IRGenerator::visit(CallExp* node) {
         args.push_back(val);
         idx++;
     }
+
+    // 实参全为常量时尝试在编译期执行纯函数，用结果替换调用
+    if (interp && !funcType->get_return_type()->is_void_type()) {
+        std::vector<ConstVal> constArgs;
+        for (auto a : args) {
+            if (auto ci = dynamic_cast<ConstantInt*>(a)) constArgs.push_back({false, ci->get_value(), 0.0f});
+            else if (auto cf = dynamic_cast<ConstantFloat*>(a)) constArgs.push_back({true, 0, cf->get_value()});
+            else break;
+        }
+        ConstVal res;
+        if (constArgs.size() == args.size() && interp->call(*interpSession, node->funcName, constArgs, res)) {
+            if (res.isFloat) return ConstantFloat::get(res.f, module);
+            return ConstantInt::get(res.i, module);
+        }
+    }
     return builder->create_call(f, args);
 }
 
 Value* IRGenerator::visit(IdExp* node) {
-    Value* ptr = scopeMgr.lookup(node->name);
+    Value* ptr = symTable->get(node->id);
     if (ptr) {
-        return builder->create_load(ptr);
+        return readVariable(ptr);
     }
     std::cerr << "Error: Unknown variable: " << node->name << std::endl;
     return ConstantInt::get(0, module);
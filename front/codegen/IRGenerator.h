@@ -2,25 +2,34 @@
 
 #include "../ast/AST.h"
 #include "../common/SymbolTable.h"
-#include "compiler_ir/include/IRbuilder.h"
+#include "ConstInterpreter.h"
+#include "compiler_ir/include/FoldingIRBuilder.h"
 #include "compiler_ir/include/Module.h"
+#include "compiler_ir/include/SSABuilder.h"
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
-
-// 【新增】定义 ConstVal 结构体，供 evaluateConst 使用
-struct ConstVal {
-    bool isFloat;
-    int i;
-    float f;
-};
+#include <vector>
 
 class IRGenerator {
 public:
     Module* module;
-    IRBuilder* builder;
+    FoldingIRBuilder* builder; // 操作数均为常量时直接折叠，不生成指令
     Function* currentFunc;
+    SymbolTable* symTable; // 作用域符号表，由调用方持有，每个生成器独立
+    std::map<std::string, ConstVal> globalConstValues; // 全局常量表，用于全局初始化表达式求值
+    int jobs; // 并行生成函数体的线程数，<= 1 时顺序生成
+    std::shared_ptr<const ConstInterpreter> interp; // 编译期解释器，声明完全局量后创建，各线程共享
+    std::unique_ptr<ConstInterpreter::Session> interpSession; // 当前函数体的求值会话，同一函数中的调用共享燃料预算与记忆
+    bool reachableOnly; // 只生成从 main 与 exports 出发可达的函数
+    std::set<std::string> exports; // reachableOnly 下额外保留的函数
+    bool ssa; // 标量局部变量与参数直接构造为 SSA 值，不经过 alloca/load/store
+    SSABuilder* ssaBuilder; // 每个函数体一个，ssa 为 true 时有效
+    std::vector<Value*> ssaVars; // SSA 模式下变量的标识：指向变量类型的指针类型 Value，不出现在 IR 中
 
-    IRGenerator(Module* m, SymbolTable* st);
+    IRGenerator(Module* m, SymbolTable* st, int jobs = 1);
+    ~IRGenerator();
     
     // Visitor 方法
     Value* visit(CompUnit* node);
@@ -30,14 +39,48 @@ public:
     Value* visit(IfStmt* node);
     Value* visit(ReturnStmt* node);
     Value* visit(BinaryExp* node);
+    Value* visit(UnaryExp* node);
     Value* visit(CallExp* node);
     Value* visit(IdExp* node);
     Value* visit(NumberExp* node);
     Value* visit(FuncFParam* node);
 
+    // 函数签名与函数体分开生成：先顺序声明全部函数，函数体可并行生成
+    Function* declareFunction(FuncDef* node);
+    // 按源码顺序生成全局变量并声明函数，返回待生成函数体的函数；
+    // node 中的函数定义可以没有函数体（逐个函数编译时只保留签名）
+    std::vector<std::pair<FuncDef*, Function*>> declareTopLevel(CompUnit* node);
+    void defineFunction(FuncDef* node, Function* f);
+
+    // 由 CallExp 构建调用图，返回从 main 与 exports 出发传递可达的函数名
+    std::set<std::string> reachableFunctions(const std::vector<FuncDef*>& defs);
+
     // 【修改】返回类型改为 ConstVal
     ConstVal evaluateConst(ASTNode* node);
 
     // 【新增】类型转换辅助函数声明
     Value* typeCast(Value* val, Type* targetType);
+
+    // 对已求值的左右操作数生成算术/比较指令
+    Value* emitBinaryOp(const std::string& op, Value* l, Value* r);
+    // 生成比较指令，返回 i1；op 不是比较运算时返回 nullptr
+    Value* emitCompare(const std::string& op, Value* l, Value* r);
+
+    // 条件上下文：按 exp 的真假直接跳转到 trueBB / falseBB，不物化布尔值
+    void genCond(Exp* exp, BasicBlock* trueBB, BasicBlock* falseBB);
+    // 将表达式求值为 i1
+    Value* genBool(Exp* exp);
+    // 值上下文中的 && / ||：短路跳转后在汇合块用 phi 取值，返回 i1
+    Value* genLogicValue(BinaryExp* node);
+
+    // 局部变量的声明、读、写：内存模式下为 alloca/load/store，SSA 模式下交给 ssaBuilder
+    Value* declareLocal(int id, Type* ty);
+    // var 为符号表中的值，全局变量始终经过内存
+    Value* readVariable(Value* var);
+    void writeVariable(Value* var, Value* val);
+
+    // 创建游离基本块，进入时才追加到当前函数末尾，使块按生成顺序排列
+    // 进入时其前驱均已生成（语言中没有循环），SSA 模式下随即封闭该块
+    BasicBlock* newBlock(const std::string& name);
+    void enterBlock(BasicBlock* bb);
 };
\ No newline at end of file
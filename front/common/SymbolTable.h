@@ -1,39 +1,89 @@
 #pragma once
-#include <map>
-#include <vector>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "../../compiler_ir/include/Value.h" 
 
-class SymbolTable {
+// 带作用域的名字表：T 为绑定的内容，查不到时返回 T{}
+template <typename T>
+class ScopedTable {
 private:
-    // 作用域栈：vector 的每个元素代表一层作用域
-    // map: 变量名 -> LLVM Value* 
-    std::vector<std::map<std::string, Value*>> scopes;
+    // 标识符驻留：名字 -> 稠密 ID，同名标识符只存一份字符串
+    std::unordered_map<std::string, int> ids;
+
+    // 每个标识符一条遮蔽栈，栈顶即当前可见的绑定
+    // depth 记录绑定所在的作用域层数，用于判断同层重复定义
+    struct Binding {
+        T val;
+        int depth;
+    };
+    std::vector<std::vector<Binding>> bindings;
+
+    // 撤销日志：按 put 顺序记录标识符 ID
+    // scopeMarks 记录每层作用域进入时日志的长度，退出时据此弹栈
+    std::vector<int> undoLog;
+    std::vector<size_t> scopeMarks;
 
 public:
-    SymbolTable() { enterScope(); } // 默认全局作用域
+    ScopedTable() { enterScope(); } // 默认全局作用域
+
+    // 驻留标识符，返回其 ID；代码生成的符号表由词法分析器填入，ID 随 token 记在 AST 上
+    int intern(const std::string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = (int)bindings.size();
+        ids.emplace(name, id);
+        bindings.emplace_back();
+        return id;
+    }
+
+    // 查询已驻留标识符的 ID，未出现过返回 -1
+    int lookupId(const std::string& name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? -1 : it->second;
+    }
 
     void enterScope() {
-        scopes.push_back({});
+        scopeMarks.push_back(undoLog.size());
     }
 
+    // 按撤销日志恢复本层作用域引入的所有绑定
     void exitScope() {
-        if (!scopes.empty()) scopes.pop_back();
+        if (scopeMarks.empty()) return;
+        size_t mark = scopeMarks.back();
+        scopeMarks.pop_back();
+        while (undoLog.size() > mark) {
+            bindings[undoLog.back()].pop_back();
+            undoLog.pop_back();
+        }
     }
 
-    // 插入符号
-    bool put(const std::string& name, Value* val) {
-        if (scopes.back().count(name)) return false; // 重复定义
-        scopes.back()[name] = val;
+    // 插入符号，ID 无效或当前作用域已有同名定义时返回 false
+    bool put(int id, const T& val) {
+        if (id < 0 || id >= (int)bindings.size()) return false;
+        auto& stack = bindings[id];
+        int depth = (int)scopeMarks.size();
+        if (!stack.empty() && stack.back().depth == depth) return false; // 重复定义
+        stack.push_back({val, depth});
+        undoLog.push_back(id);
         return true;
     }
+    // 按名字访问的版本每次多一次哈希查找，供手中没有 ID 的调用方使用
+    bool put(const std::string& name, const T& val) {
+        return put(intern(name), val);
+    }
 
-    // 查找符号 (从栈顶向下查找)
-    Value* get(const std::string& name) {
-        for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
-            if (it->count(name)) return (*it)[name];
-        }
-        return nullptr;
+    // 查找符号：直接取遮蔽栈栈顶，与嵌套深度无关
+    T get(int id) const {
+        if (id < 0 || id >= (int)bindings.size() || bindings[id].empty()) return T{};
+        return bindings[id].back().val;
     }
-    bool isGlobal() const { return scopes.size() == 1; }
-};
\ No newline at end of file
+    T get(const std::string& name) const {
+        return get(lookupId(name));
+    }
+
+    bool isGlobal() const { return scopeMarks.size() == 1; }
+};
+
+// 代码生成使用的符号表：名字 -> 变量地址（alloca 或全局变量）
+using SymbolTable = ScopedTable<Value*>;
@@ -27,4 +27,5 @@ struct Token {
     TokenType type;
     std::string content;
     int line;
+    int id = -1; // 标识符在符号表中的 ID，其余 token 为 -1
 };
\ No newline at end of file
@@ -47,6 +47,7 @@ Token Lexer::nextInternal() {
     State state = START;
     string buffer;
     TokenType type;
+    int id = -1;
 
     while (state != DONE) {
         char ch = getChar();
@@ -58,8 +59,8 @@ Token Lexer::nextInternal() {
             if (state == IN_INT) return {INT_CONST, buffer, lineNo};
             if (state == IN_ID) {
                 // [修复] EOF处的 ID 也要填表
-                if (symTable) symTable->put(buffer, nullptr); 
-                return {ID, buffer, lineNo};
+                if (symTable) id = symTable->intern(buffer);
+                return {ID, buffer, lineNo, id};
             }
             return {END_OFF, "", lineNo};
         }
@@ -119,10 +120,10 @@ Token Lexer::nextInternal() {
                 } else {
                     type = ID;
                     // [核心改进] 满足“词法分析器填写符号表”的要求
-                    // 将识别到的标识符名称填入符号表，Value 暂时置空
-                    // 这里的 put 会利用 SymbolTable 默认的全局作用域
+                    // 将识别到的标识符名称驻留到符号表，ID 随 token 进入 AST，
+                    // 绑定由 IRGenerator 按作用域以 ID 建立
                     if (symTable) {
-                        symTable->put(buffer, nullptr);
+                        id = symTable->intern(buffer);
                     }
                 }
             }
@@ -232,7 +233,7 @@ Token Lexer::nextInternal() {
             break;
         }
     }
-    return {type, buffer, lineNo};
+    return {type, buffer, lineNo, id};
 }
 
 Token Lexer::next() {
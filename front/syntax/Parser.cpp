@@ -16,7 +16,7 @@ ASTNode* Parser::makeLeaf(const Token& tok) {
         case KW_VOID:
         case KW_FLOAT:
         case KW_MAIN: // main 视为标识符处理
-            return new IdExp(tok.content); 
+            return new IdExp(tok.content, tok.id); 
 
         // 【核心修复】: 处理所有运算符，将其作为 IdExp 返回
         // 这样 buildAST 中的 getChild(children, 1) 才能正确获取操作符内容
@@ -50,12 +50,14 @@ ASTNode* Parser::buildAST(const Production& prod, std::vector<ASTNode*>& childre
             auto root = dynamic_cast<CompUnit*>(getChild(children, 0));
             ASTNode* item = getChild(children, 1);
             if (!root) root = new CompUnit();
-            if (item) root->children.push_back(item);
+            if (item && onTopLevel) onTopLevel(item);
+            else if (item) root->children.push_back(item);
             return root;
         }
         auto root = new CompUnit();
         ASTNode* item = getChild(children, 0);
-        if (item) root->children.push_back(item);
+        if (item && onTopLevel) onTopLevel(item);
+        else if (item) root->children.push_back(item);
         return root;
     }
 
@@ -98,8 +100,12 @@ ASTNode* Parser::buildAST(const Production& prod, std::vector<ASTNode*>& childre
         std::string type = "int";
         if (auto t = dynamic_cast<IdExp*>(getChild(children, 0))) type = t->name;
         std::string name = "";
-        if (auto id = dynamic_cast<IdExp*>(getChild(children, 1))) name = id->name;
-        return new FuncFParam(type, name);
+        int symId = -1;
+        if (auto id = dynamic_cast<IdExp*>(getChild(children, 1))) {
+            name = id->name;
+            symId = id->id;
+        }
+        return new FuncFParam(type, name, symId);
     }
     if (lhs == "funcFParamsOpt") {
         if (children.empty()) return new CompUnit();
@@ -127,6 +133,7 @@ ASTNode* Parser::buildAST(const Production& prod, std::vector<ASTNode*>& childre
              for (auto child : list->children) {
                  if (auto v = dynamic_cast<VarDefStmt*>(child)) {
                      v->type = typeName;
+                     v->isConst = (lhs == "constDecl");
                  }
              }
         }
@@ -154,7 +161,7 @@ ASTNode* Parser::buildAST(const Production& prod, std::vector<ASTNode*>& childre
             // 检查是否有初始化值
             if (len >= 3) init = dynamic_cast<Exp*>(getChild(children, 2));
             // 默认类型先设为 "int"，稍后在 varDecl 中被修正
-            return new VarDefStmt("int", id->name, init); 
+            return new VarDefStmt("int", id->name, init, id->id); 
         }
     }
     
@@ -269,11 +276,11 @@ ASTNode* Parser::buildAST(const Production& prod, std::vector<ASTNode*>& childre
              }
              Exp* exp = dynamic_cast<Exp*>(getChild(children, 1));
              
-             // 将单目运算转换为等价的二元运算，复用 IRGenerator 逻辑
-             // 逻辑非: !E  =>  E == 0
+             // 逻辑非保留为 UnaryExp，条件上下文中可直接交换跳转目标
              if (op == "!" || op == "OP_NOT") {
-                 return new BinaryExp("==", exp, new NumberExp(0));
+                 return new UnaryExp("!", exp);
              }
+             // 其余单目运算转换为等价的二元运算，复用 IRGenerator 逻辑
              // 负号: -E  =>  0 - E
              else if (op == "-" || op == "OP_MINUS") {
                  return new BinaryExp("-", new NumberExp(0), exp);
@@ -322,7 +329,7 @@ ASTNode* Parser::parse() {
         else actionStr = "error";
 
         // 输出分析过程，严格符合格式要求
-        std::cout << stepCount++ << "\t" << stackTopSym << "#" << inputSym << "\t" << actionStr << std::endl;
+        if (trace) std::cout << stepCount++ << "\t" << stackTopSym << "#" << inputSym << "\t" << actionStr << std::endl;
 
         if (act.type == Action::SHIFT) {
             stateStack.push(act.target);
@@ -2,6 +2,7 @@
 #include "SLRGenerator.h"
 #include "../lexer/Lexer.h"
 #include "../ast/AST.h"
+#include <functional>
 #include <stack>
 #include <iostream>
 
@@ -23,5 +24,11 @@ private:
 public:
     Parser(Lexer& l, SLRGenerator& s) : lexer(l), slr(s) {}
 
+    // 设置后每个顶层项（函数定义或全局声明）归约完成即交给回调，
+    // 不再挂到 CompUnit 上，parse 返回的 CompUnit 为空；用于逐个函数编译
+    std::function<void(ASTNode*)> onTopLevel;
+    // 为 false 时不输出归约过程
+    bool trace = true;
+
     ASTNode* parse(); // 主入口
 };
\ No newline at end of file
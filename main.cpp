@@ -2,12 +2,19 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "compiler_ir/include/Bitcode.h"
 #include "compiler_ir/include/Module.h"
 #include "front/common/SymbolTable.h"
 #include "front/lexer/Lexer.h"
 #include "front/syntax/SLRGenerator.h"
 #include "front/syntax/Parser.h"
 #include "front/codegen/IRGenerator.h"
+#include "front/codegen/ConstPropagator.h"
 
 // 辅助函数：根据用户提供的规则输出 Token
 void printToken(const Token& t) {
@@ -87,13 +94,137 @@ void printToken(const Token& t) {
     std::cout << t.content << "\t<" << typeStr << ", " << attr << ">" << std::endl;
 }
 
+// --stream：逐个函数编译，内存峰值取决于最大的函数而不是整个文件，输出与整体编译相同
+//   第一遍解析：输出归约过程；每个顶层项归约完成即做常量传播，保留全局声明与函数签名，
+//     函数体交给编译期解释器收集摘要后释放，只留下可能为纯函数的（解释器要执行它们）
+//   按源码顺序生成全局变量、声明全部函数，此时全局量已齐全，先输出模块头部与全局变量
+//   第二遍解析：不输出归约过程，每个函数归约完成即生成、输出，随后释放其 AST 与函数体
+int compileStreaming(const std::string& sourceFile, SymbolTable& symTable,
+                     SLRGenerator& slrGen, bool ssa) {
+    auto interp = std::make_shared<ConstInterpreter>();
+    CompUnit* skeleton = new CompUnit();
+    {
+        ConstPropagator constProp;
+        Lexer lexer(sourceFile, &symTable);
+        Parser parser(lexer, slrGen);
+        parser.onTopLevel = [&](ASTNode* item) {
+            constProp.visitTopLevel(item);
+            if (auto fd = dynamic_cast<FuncDef*>(item)) {
+                if (!interp->addFunction(fd)) {
+                    ASTNode::destroyTree(fd->body);
+                    fd->body = nullptr;
+                }
+            }
+            skeleton->children.push_back(item);
+        };
+        ASTNode* root = parser.parse();
+        if (!root) {
+            ASTNode::destroyTree(skeleton);
+            return 1;
+        }
+        ASTNode::destroyTree(root);
+    }
+
+    Module module("sysy2022_compiler");
+    IRGenerator irGen(&module, &symTable);
+    irGen.ssa = ssa;
+    auto funcs = irGen.declareTopLevel(skeleton);
+    interp->finish(irGen.globalConstValues);
+    for (auto& fn : funcs) {
+        if (!interp->isPure(fn.first->name)) {
+            ASTNode::destroyTree(fn.first->body);
+            fn.first->body = nullptr;
+        }
+    }
+    if (!funcs.empty()) irGen.interp = interp;
+
+    std::cout << "; ModuleID = 'sysy2022_compiler'" << std::endl;
+    std::cout << "source_filename = \"" << sourceFile << "\"" << std::endl;
+    {
+        IROStream os(std::cout);
+        module.print_globals(os);
+
+        ConstPropagator constProp;
+        Lexer lexer(sourceFile, &symTable);
+        Parser parser(lexer, slrGen);
+        parser.trace = false;
+        size_t next = 0;
+        parser.onTopLevel = [&](ASTNode* item) {
+            constProp.visitTopLevel(item);
+            if (dynamic_cast<FuncDef*>(item) && next < funcs.size()) {
+                Function* f = funcs[next].second;
+                irGen.defineFunction(static_cast<FuncDef*>(item), f);
+                f->print(os);
+                os << '\n';
+                f->delete_body();
+                next++;
+            }
+            ASTNode::destroyTree(item);
+        };
+        ASTNode::destroyTree(parser.parse());
+        os << '\n';
+    }
+    std::cout.flush();
+
+    ASTNode::destroyTree(skeleton);
+    return 0;
+}
+
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: ./compiler <source_file>" << std::endl;
+        std::cerr << "Usage: ./compiler <source_file> [-j <threads>] [--reachable-only] [--export <f1,f2,...>] [--ssa] [--emit-bc <file>] [--stream]" << std::endl;
         return 1;
     }
     std::string sourceFile = argv[1];
 
+    // 可选参数：
+    //   -j N              并行生成函数体的线程数，0 表示使用全部硬件线程
+    //   --reachable-only  只生成从 main 可达的函数
+    //   --export f1,f2    --reachable-only 下额外保留的函数（可重复给出）
+    //   --ssa             局部变量直接生成 SSA 形式，不经过 alloca/load/store
+    //   --emit-bc file    另将模块以二进制格式写入 file，供之后直接读取
+    //   --stream          逐个函数生成、输出并释放，用于很大的输入；函数按顺序生成，不能与
+    //                     --reachable-only、--emit-bc 同用（二者都需要整个模块）
+    int jobs = 1;
+    bool reachableOnly = false;
+    bool ssa = false;
+    bool stream = false;
+    std::string bitcodeFile;
+    std::set<std::string> exports;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            jobs = std::atoi(argv[++i]);
+        } else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+            jobs = std::atoi(arg.c_str() + 2);
+        } else if (arg == "--reachable-only") {
+            reachableOnly = true;
+        } else if (arg == "--ssa") {
+            ssa = true;
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--emit-bc" && i + 1 < argc) {
+            bitcodeFile = argv[++i];
+        } else if (arg == "--export" && i + 1 < argc) {
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = list.find(',', start);
+                if (comma == std::string::npos) comma = list.size();
+                if (comma > start) exports.insert(list.substr(start, comma - start));
+                start = comma + 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (jobs <= 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    if (stream && (reachableOnly || !bitcodeFile.empty())) {
+        std::cerr << "--stream cannot be combined with --reachable-only or --emit-bc" << std::endl;
+        return 1;
+    }
+
     // 1. 初始化符号表
     SymbolTable symTable; 
 
@@ -115,6 +246,8 @@ int main(int argc, char** argv) {
     
     slrGen.build(); 
 
+    if (stream) return compileStreaming(sourceFile, symTable, slrGen, ssa);
+
     // 3. 语法分析 & 构建 AST & 输出归约过程
     // Parser 内部已修改为打印归约序列
     Parser parser(lexer, slrGen);
@@ -125,16 +258,34 @@ int main(int argc, char** argv) {
         return 1; 
     }
 
-    // 4. 中间代码生成
+    // 4. AST 上的常量传播与常量条件分支裁剪
+    ConstPropagator constProp;
+    constProp.run(dynamic_cast<CompUnit*>(root));
+
+    // 5. 中间代码生成
     Module module("sysy2022_compiler"); 
-    IRGenerator irGen(&module, &symTable);
+    IRGenerator irGen(&module, &symTable, jobs);
+    irGen.reachableOnly = reachableOnly;
+    irGen.exports = exports;
+    irGen.ssa = ssa;
     
     root->accept(irGen); 
 
-    // 5. 输出最终 IR (带题目要求的头部)
+    if (!bitcodeFile.empty() && !write_bitcode_file(&module, bitcodeFile)) {
+        std::cerr << "Cannot write " << bitcodeFile << std::endl;
+        return 1;
+    }
+
+    // 6. 输出最终 IR (带题目要求的头部)
     std::cout << "; ModuleID = 'sysy2022_compiler'" << std::endl;
     std::cout << "source_filename = \"" << sourceFile << "\"" << std::endl;
-    std::cout << module.print() << std::endl;
+    {
+        IROStream os(std::cout);
+        module.print(os, jobs);
+        os << '\n';
+    }
+    std::cout.flush();
 
+    ASTNode::destroyTree(root);
     return 0;
 }
\ No newline at end of file
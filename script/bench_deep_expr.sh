@@ -0,0 +1,42 @@
+#!/bin/bash
+# -----------------------------------------------------------------------------
+# 超长表达式压力测试：生成 N 项的 a + a + ... 左深加法链并编译
+# 用法: script/bench_deep_expr.sh <compiler 可执行文件> [项数, 默认 1000000] [栈上限 KB, 默认 1024]
+# 编译器按 ../../grammar.txt 加载文法，因此在 build/bench_deep_expr 目录下运行
+# -----------------------------------------------------------------------------
+if [ -z "$1" ]; then
+    echo "Usage: $0 <compiler> [terms] [stack_kb]"
+    exit 1
+fi
+COMPILER=$(realpath "$1")
+TERMS=${2:-1000000}
+STACK_KB=${3:-1024}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+WORK="$ROOT/build/bench_deep_expr"
+mkdir -p "$WORK"
+cd "$WORK"
+
+# -----------------------------------------------------------------------------
+# 生成测试源文件
+SRC="deep_${TERMS}.sy"
+{
+    echo "int main() {"
+    echo "    int a = 1;"
+    printf "    return a"
+    for ((i = 1; i < TERMS; i += 1000)); do
+        n=$((TERMS - i < 1000 ? TERMS - i : 1000))
+        printf ' + a%.0s' $(seq 1 $n)
+    done
+    echo ";"
+    echo "}"
+} > "$SRC"
+
+# -----------------------------------------------------------------------------
+# 限制栈大小后编译，只统计耗时，输出丢弃
+ulimit -s "$STACK_KB"
+START=$(date +%s%N)
+"$COMPILER" "$SRC" > /dev/null
+STATUS=$?
+END=$(date +%s%N)
+echo "terms=$TERMS stack=${STACK_KB}KB status=$STATUS time=$(( (END - START) / 1000000 ))ms"
+exit $STATUS
@@ -0,0 +1,49 @@
+#!/bin/bash
+# -----------------------------------------------------------------------------
+# 二进制模块往返检查：对每个测试用例分别以默认与 --ssa 模式编译并写出 .bc，
+# 再用 project1 分别直接读入与延迟解码（--lazy）后输出，与编译器打印的中间代码逐字比较
+# 用法: script/check_bitcode.sh <compiler 可执行文件> <project1 可执行文件> [测试用例目录, 默认 testcase]
+# 编译器按 ../../grammar.txt 加载文法，因此在 build/check_bitcode 目录下运行
+# -----------------------------------------------------------------------------
+if [ -z "$2" ]; then
+    echo "Usage: $0 <compiler> <project1> [testcase_dir]"
+    exit 1
+fi
+COMPILER=$(realpath "$1")
+PROJECT1=$(realpath "$2")
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CASES=$(realpath "${3:-$ROOT/testcase}")
+WORK="$ROOT/build/check_bitcode"
+mkdir -p "$WORK"
+cd "$WORK"
+
+# -----------------------------------------------------------------------------
+# 编译器的标准输出先是 token 与归约序列，中间代码从 ModuleID 一行开始；
+# 两者的头部（ModuleID 与 source_filename）不同，只比较其后的内容
+PASS=0
+FAIL=0
+for SRC in "$CASES"/*.sy; do
+    NAME=$(basename "$SRC" .sy)
+    for MODE in "" "--ssa"; do
+        TAG="$NAME${MODE:+ $MODE}"
+        BC="$NAME${MODE}.bc"
+        rm -f "$BC"
+        "$COMPILER" "$SRC" $MODE --emit-bc "$BC" 2>/dev/null \
+            | sed -n '/^; ModuleID/,$p' | sed '1,2d' > expected.ll
+        if [ ! -s expected.ll ] || [ ! -f "$BC" ]; then
+            echo "FAIL $TAG: compile"
+            FAIL=$((FAIL + 1))
+            continue
+        fi
+        for READ in "" "--lazy"; do
+            if "$PROJECT1" "$BC" $READ | sed '1d' | diff -q expected.ll - > /dev/null; then
+                PASS=$((PASS + 1))
+            else
+                echo "FAIL $TAG: project1 ${READ:-eager}"
+                FAIL=$((FAIL + 1))
+            fi
+        done
+    done
+done
+echo "passed=$PASS failed=$FAIL"
+[ "$FAIL" -eq 0 ]